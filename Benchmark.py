@@ -0,0 +1,220 @@
+#!/usr/bin/env python
+
+# Translates each sample application for every backend, builds and runs the
+# generated code, and records per-kernel timings, bandwidth and the final
+# residual in a machine-readable report. When a reference report is given,
+# residuals outside tolerance and kernels that slowed down are flagged so
+# that performance regressions in generated code are caught between
+# translator versions.
+#
+# Each application directory holds a 'config' file of 'key=value' lines.
+# Besides the 'files' key listing the sources to translate, the following
+# optional keys are understood:
+#   flags=<extra translator flags>
+#   iterations=<number of iterations the application runs>
+#   build_<backend>=<shell command building the generated code>
+#   run_<backend>=<shell command running the built executable>
+# When no build command is given, 'make -f Makefile.<backend>' is used if
+# that file exists; when no run command is given, './<directory>_<backend>'
+# is used. <backend> is one of 'cuda', 'openmp' or 'opencl'.
+#
+# The OpenCL output is meant to be run against a CPU runtime such as pocl,
+# so the harness works on machines without a GPU: point the build command
+# at the pocl ICD loader through the environment (e.g. OPENCL_LIB).
+#
+# By default only the C++ airfoil applications are benchmarked, as they are
+# the ones whose configuration builds and runs every backend. Every backend
+# is translated, but the CUDA output is only built and run with --cuda.
+# The build commands expect OP2_INSTALL_PATH to point at the OP2 libraries
+# and AIRFOIL_GRID at the grid file (new_grid.dat).
+#
+# A run whose last reported iteration differs from the configured
+# 'iterations' is flagged. Results are compared against
+# 'benchmark-reference.json' unless another report is given with
+# --reference. The committed reference only holds the residual OP2
+# validates airfoil against on new_grid.dat in double precision, since
+# timings only compare on the machine where they were measured: to also
+# catch kernel slowdowns, save the report of a known-good translator and
+# pass it with --reference.
+
+import json
+import optparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+backendFlags = {"cuda": "--CUDA", "openmp": "--OpenMP", "opencl": "--OpenCL"}
+
+defaultApplications = ["C++/airfoil", "C++/airfoil-fusable"]
+
+# Lines printed by the applications while iterating: ' <iteration>  <residual>'
+residualRegex = re.compile(r"^\s*(\d+)\s+([-+]?\d+\.\d+[eE][-+]?\d+)\s*$")
+
+# Lines printed by op_timing_output: '<count> <time> [<GB/s>] [<GB/s>] <name>'
+kernelRegex = re.compile(r"^\s*(\d+)\s+(\d+\.\d+)((?:\s+\d+\.\d+){0,2})\s+([A-Za-z_]\w*)\s*$")
+
+def readConfiguration (directory):
+    configuration = {}
+    fileName = os.path.join(directory, "config")
+    if os.path.exists(fileName):
+        for line in open(fileName):
+            line = line.strip()
+            if line and not line.startswith("#") and "=" in line:
+                key, value = line.split("=", 1)
+                configuration[key.strip()] = value.strip()
+    return configuration
+
+def runCommand (command, directory, logFile, environment):
+    start = time.time()
+    log = open(logFile, "w")
+    process = subprocess.Popen(command, cwd=directory, shell=True,
+                               stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT, env=environment)
+    output = process.communicate()[0].decode("utf-8", "replace")
+    log.write(output)
+    log.close()
+    return process.returncode, output, time.time() - start
+
+def parseOutput (output):
+    result = {"iterations": 0, "residual": None, "kernels": {}}
+    for line in output.splitlines():
+        match = residualRegex.match(line)
+        if match:
+            result["iterations"] = int(match.group(1))
+            result["residual"] = float(match.group(2))
+            continue
+        match = kernelRegex.match(line)
+        if match:
+            bandwidths = [float(value) for value in match.group(3).split()]
+            result["kernels"][match.group(4)] = {
+                "count": int(match.group(1)),
+                "time": float(match.group(2)),
+                "bandwidth": bandwidths[-1] if bandwidths else None}
+    return result
+
+def compare (result, reference, options):
+    problems = []
+    if reference.get("iterations") and result.get("iterations") != reference["iterations"]:
+        problems.append("ran %s iterations, reference ran %d" % (result.get("iterations"), reference["iterations"]))
+    if reference.get("residual") is not None:
+        if result.get("residual") is None:
+            problems.append("no residual reported")
+        else:
+            expected = reference["residual"]
+            error = abs(result["residual"] - expected) / max(abs(expected), 1e-300)
+            if error > options.tolerance:
+                problems.append("residual %g differs from reference %g" % (result["residual"], expected))
+    for name, kernel in reference.get("kernels", {}).items():
+        if name not in result["kernels"]:
+            problems.append("kernel '%s' not reported" % name)
+        elif kernel["time"] > 0:
+            slowdown = result["kernels"][name]["time"] / kernel["time"] - 1.0
+            if slowdown > options.slowdown:
+                problems.append("kernel '%s' is %.0f%% slower than reference" % (name, 100 * slowdown))
+    return problems
+
+def benchmark (application, backend, options, environment):
+    directory = os.path.join(options.root, application)
+    configuration = readConfiguration(directory)
+    result = {"application": application, "backend": backend, "status": "ok"}
+    logPrefix = os.path.join(options.logs, application.replace("/", "_") + "." + backend)
+
+    translate = " ".join([options.translator, backendFlags[backend],
+                          configuration.get("flags", ""),
+                          configuration.get("files", "")])
+    code, output, elapsed = runCommand(translate, directory, logPrefix + ".translate.log", environment)
+    result["translationTime"] = elapsed
+    if code != 0:
+        result["status"] = "translation failed"
+        return result
+
+    if backend == "cuda" and not options.cuda:
+        result["status"] = "translated"
+        return result
+
+    build = configuration.get("build_" + backend)
+    if build is None and os.path.exists(os.path.join(directory, "Makefile." + backend)):
+        build = "make -f Makefile." + backend
+    if build is None:
+        result["status"] = "no build command"
+        return result
+    code, output, elapsed = runCommand(build, directory, logPrefix + ".build.log", environment)
+    if code != 0:
+        result["status"] = "build failed"
+        return result
+
+    run = configuration.get("run_" + backend, "./" + os.path.basename(directory) + "_" + backend)
+    code, output, elapsed = runCommand(run, directory, logPrefix + ".run.log", environment)
+    result["runTime"] = elapsed
+    if code != 0:
+        result["status"] = "run failed"
+        return result
+
+    result.update(parseOutput(output))
+    if "iterations" in configuration and result["iterations"] != int(configuration["iterations"]):
+        result["problems"] = ["ran %d iterations instead of %s" % (result["iterations"], configuration["iterations"])]
+    return result
+
+def main ():
+    parser = optparse.OptionParser(usage="%prog [options] [application ...]")
+    parser.add_option("--translator", default=os.path.abspath("bin/translator"),
+                      help="translator binary [default: %default]")
+    parser.add_option("--root", default=os.path.abspath("."),
+                      help="directory containing the sample applications [default: %default]")
+    parser.add_option("--backends", default="cuda,openmp,opencl",
+                      help="comma-separated backends to translate and benchmark [default: %default]")
+    parser.add_option("--cuda", action="store_true", default=False,
+                      help="also build and run the CUDA output (requires a GPU)")
+    parser.add_option("--threads", type="int", default=None,
+                      help="thread count exported as OMP_NUM_THREADS")
+    parser.add_option("--reference", default=os.path.abspath("benchmark-reference.json"),
+                      help="reference report to compare against [default: %default]")
+    parser.add_option("--tolerance", type="float", default=1e-5,
+                      help="relative residual tolerance, above the precision of the printed residuals [default: %default]")
+    parser.add_option("--slowdown", type="float", default=0.10,
+                      help="tolerated relative kernel slowdown [default: %default]")
+    parser.add_option("--output", default="benchmark.json",
+                      help="report file [default: %default]")
+    parser.add_option("--logs", default=os.path.abspath("benchmark-logs"),
+                      help="directory for per-step logs [default: %default]")
+    (options, applications) = parser.parse_args()
+
+    if not applications:
+        applications = defaultApplications
+    if not os.path.isdir(options.logs):
+        os.makedirs(options.logs)
+
+    environment = dict(os.environ)
+    if options.threads is not None:
+        environment["OMP_NUM_THREADS"] = str(options.threads)
+
+    reference = {}
+    if options.reference and os.path.exists(options.reference):
+        for entry in json.load(open(options.reference))["results"]:
+            reference[(entry["application"], entry["backend"])] = entry
+
+    results = []
+    failures = 0
+    for application in applications:
+        for backend in options.backends.split(","):
+            result = benchmark(application, backend, options, environment)
+            key = (application, backend)
+            if result["status"] == "ok" and key in reference:
+                result["problems"] = result.get("problems", []) + compare(result, reference[key], options)
+            if result["status"].endswith("failed") or result.get("problems"):
+                failures += 1
+            sys.stdout.write("%-40s %-8s %s\n" % (application, backend, result["status"]))
+            for problem in result.get("problems", []):
+                sys.stdout.write("    %s\n" % problem)
+            results.append(result)
+
+    report = {"translator": options.translator,
+              "date": time.strftime("%Y-%m-%d %H:%M:%S"),
+              "results": results}
+    json.dump(report, open(options.output, "w"), indent=2, sort_keys=True)
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -36,6 +36,102 @@
 #include <RoseStatementsAndExpressionsBuilder.h>
 #include <CUDA.h>
 #include <CompilerGeneratedNames.h>
+#include <Globals.h>
+#include <Exceptions.h>
+#include <OP2.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+  /*
+   * ======================================================
+   * Registers assumed to be taken by indexing, plan and
+   * bookkeeping variables in every generated kernel
+   * ======================================================
+   */
+  unsigned int const baseRegisterCount = 16;
+
+  /*
+   * ======================================================
+   * Reads the register limits file selected on the command
+   * line. Each line has the form 'kernel=registers'; empty
+   * lines and lines starting with '#' are ignored
+   * ======================================================
+   */
+  std::map <std::string, unsigned int> const &
+  getRegisterLimits ()
+  {
+    using boost::lexical_cast;
+    using boost::bad_lexical_cast;
+    using boost::trim_copy;
+    using std::ifstream;
+    using std::map;
+    using std::string;
+
+    static map <string, unsigned int> registerLimits;
+
+    static bool parsed = false;
+
+    if (parsed == false)
+    {
+      parsed = true;
+
+      string const & fileName =
+          Globals::getInstance ()->getCUDARegisterLimitsFileName ();
+
+      if (fileName.empty () == false)
+      {
+        ifstream inputFile (fileName.c_str ());
+
+        if (inputFile.is_open () == false)
+        {
+          throw Exceptions::ASTParsing::NoSourceFileException (
+              "Unable to open CUDA register limits file '" + fileName + "'");
+        }
+
+        string line;
+
+        unsigned int lineNumber = 0;
+
+        while (getline (inputFile, line))
+        {
+          ++lineNumber;
+
+          line = trim_copy (line);
+
+          size_t const separator = line.find ('=');
+
+          if (line.empty () || line[0] == '#' || separator == string::npos)
+          {
+            continue;
+          }
+
+          string const kernelName = trim_copy (line.substr (0, separator));
+
+          string const registers = trim_copy (line.substr (separator + 1));
+
+          try
+          {
+            registerLimits[kernelName] = lexical_cast <unsigned int> (
+                registers);
+          }
+          catch (bad_lexical_cast const &)
+          {
+            throw Exceptions::CommandLine::LanguageException ("Register limit '"
+                + registers + "' given for kernel '" + kernelName + "' in '"
+                + fileName + "', line " + lexical_cast <string> (lineNumber)
+                + ", is not an integer");
+          }
+        }
+      }
+    }
+
+    return registerLimits;
+  }
+}
 
 void
 CPPCUDAKernelSubroutine::createReductionPrologueStatements ()
@@ -348,6 +444,93 @@ CPPCUDAKernelSubroutine::createReductionVariableDeclarations ()
   }
 }
 
+unsigned int
+CPPCUDAKernelSubroutine::getEstimatedRegisterCount ()
+{
+  unsigned int registerCount = baseRegisterCount;
+
+  for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+  {
+    if (parallelLoop->isDuplicateOpDat (i) == false)
+    {
+      /*
+       * ======================================================
+       * One 64-bit pointer per argument plus the 32-bit words
+       * of one element, which the user kernel holds while it
+       * executes
+       * ======================================================
+       */
+
+      registerCount += 2 + (parallelLoop->getSizeOfOpDat (i)
+          * parallelLoop->getOpDatDimension (i) + 3) / 4;
+    }
+  }
+
+  return registerCount;
+}
+
+void
+CPPCUDAKernelSubroutine::createLaunchBounds ()
+{
+  using namespace SageInterface;
+  using boost::lexical_cast;
+  using std::map;
+  using std::max;
+  using std::string;
+
+  string const & userSubroutineName = parallelLoop->getUserSubroutineName ();
+
+  unsigned int const estimatedRegisters = getEstimatedRegisterCount ();
+
+  unsigned int const registerBudget = std::min (CUDA::maximumRegistersPerThread,
+      CUDA::registersPerMultiprocessor / OP2::defaultBlockSize);
+
+  string launchBounds = "__launch_bounds__ (" + lexical_cast <string> (
+      OP2::defaultBlockSize);
+
+  map <string, unsigned int> const & registerLimits = getRegisterLimits ();
+
+  map <string, unsigned int>::const_iterator it = registerLimits.find (
+      userSubroutineName);
+
+  if (it != registerLimits.end ())
+  {
+    unsigned int const minimumBlocks = max (1u,
+        CUDA::registersPerMultiprocessor / (max (1u, it->second)
+            * OP2::defaultBlockSize));
+
+    launchBounds += ", " + lexical_cast <string> (minimumBlocks);
+
+    if (estimatedRegisters > it->second)
+    {
+      std::cout << "Warning: kernel '" << subroutineName
+          << "' is estimated to need " << estimatedRegisters
+          << " registers but is limited to " << it->second
+          << "; expect register spilling" << std::endl;
+    }
+  }
+
+  launchBounds += ")\n";
+
+  addTextForUnparser (subroutineHeaderStatement, launchBounds,
+      AstUnparseAttribute::e_before);
+
+  Debug::getInstance ()->debugMessage ("Kernel '" + subroutineName
+      + "': " + lexical_cast <string> (
+      parallelLoop->getNumberOfOpDatArgumentGroups ())
+      + " arguments, estimated " + lexical_cast <string> (estimatedRegisters)
+      + " registers per thread", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  if (estimatedRegisters > registerBudget)
+  {
+    std::cout << "Warning: kernel '" << subroutineName
+        << "' is estimated to need " << estimatedRegisters
+        << " registers per thread; only " << registerBudget
+        << " are available at a block size of " << OP2::defaultBlockSize
+        << ", so occupancy will be limited by register pressure" << std::endl;
+  }
+}
+
 CPPCUDAKernelSubroutine::CPPCUDAKernelSubroutine (
     SgScopeStatement * moduleScope, CPPCUDAUserSubroutine * userSubroutine,
     CPPParallelLoop * parallelLoop,
@@ -357,4 +540,6 @@ CPPCUDAKernelSubroutine::CPPCUDAKernelSubroutine (
   this->reductionSubroutines = reductionSubroutines;
 
   subroutineHeaderStatement->get_functionModifier ().setCudaKernel ();
+
+  createLaunchBounds ();
 }
@@ -41,6 +41,29 @@ class CPPReductionSubroutines;
 
 class CPPCUDAKernelSubroutine: public CPPKernelSubroutine
 {
+  private:
+
+    /*
+     * ======================================================
+     * A static estimate of the number of registers needed per
+     * thread, based on the OP_DAT arguments and their
+     * dimensions
+     * ======================================================
+     */
+    unsigned int
+    getEstimatedRegisterCount ();
+
+    /*
+     * ======================================================
+     * Annotates the kernel with launch bounds derived from the
+     * block size and the register limit (if any) given for
+     * this kernel, and flags kernels whose occupancy will be
+     * limited by register pressure
+     * ======================================================
+     */
+    void
+    createLaunchBounds ();
+
   protected:
 
     /*
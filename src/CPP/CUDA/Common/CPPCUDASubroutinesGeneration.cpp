@@ -45,6 +45,8 @@
 #include "CUDA.h"
 #include "OP2.h"
 #include "OP2Definitions.h"
+#include "Globals.h"
+#include "Statistics.h"
 
 void
 CPPCUDASubroutinesGeneration::addFreeVariableDeclarations ()
@@ -124,6 +126,16 @@ CPPCUDASubroutinesGeneration::addHeaderIncludes ()
   addTextForUnparser (moduleScope, "#include \""
       + CUDA::Libraries::CPP::OP2RuntimeSupport + "\"\n",
       AstUnparseAttribute::e_before);
+
+  if (Globals::getInstance ()->generateCUDATemplates ())
+  {
+    Debug::getInstance ()->debugMessage ("Adding CUDA staging templates",
+        Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+    addTextForUnparser (moduleScope,
+        CUDA::OP2RuntimeSupport::getStageTemplatesSource (),
+        AstUnparseAttribute::e_before);
+  }
 }
 
 void
@@ -132,45 +144,95 @@ CPPCUDASubroutinesGeneration::createSubroutines ()
   using std::string;
   using std::map;
 
+  Statistics::getInstance ()->beginPhase ("reductions");
+
   createReductionSubroutines ();
 
+  Statistics::getInstance ()->endPhase ();
+
   for (map <string, ParallelLoop *>::const_iterator it =
       declarations->firstParallelLoop (); it
       != declarations->lastParallelLoop (); ++it)
   {
     string const userSubroutineName = it->first;
 
+    Statistics::getInstance ()->beginPhase ("loop " + userSubroutineName);
+
     Debug::getInstance ()->debugMessage ("Analysing user subroutine '"
         + userSubroutineName + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
     CPPParallelLoop * parallelLoop =
         static_cast <CPPParallelLoop *> (it->second);
 
+    Statistics::getInstance ()->beginPhase ("user");
+
     CPPCUDAUserSubroutine * userDeviceSubroutine = new CPPCUDAUserSubroutine (
         moduleScope, parallelLoop, declarations);
 
+    Statistics::getInstance ()->endPhase ();
+
     userSubroutines[userSubroutineName] = userDeviceSubroutine;
 
+    userDeviceSubroutine = static_cast <CPPCUDAUserSubroutine *> (
+        shareUserSubroutine (userDeviceSubroutine));
+
     CPPCUDAKernelSubroutine * kernelSubroutine;
 
     if (parallelLoop->isDirectLoop ())
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPCUDAKernelSubroutineDirectLoop (moduleScope,
           userDeviceSubroutine, parallelLoop, reductionSubroutines);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPCUDAHostSubroutineDirectLoop (moduleScope, kernelSubroutine,
               parallelLoop, moduleDeclarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
     else
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPCUDAKernelSubroutineIndirectLoop (moduleScope,
           userDeviceSubroutine, parallelLoop, reductionSubroutines);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPCUDAHostSubroutineIndirectLoop (moduleScope,
               kernelSubroutine, parallelLoop, moduleDeclarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
+
+    addBuiltSubroutine (kernelSubroutine->getSubroutineHeaderStatement ());
+
+    addBuiltSubroutine (
+        hostSubroutines[userSubroutineName]->getSubroutineHeaderStatement ());
+
+    /*
+     * ======================================================
+     * Only the header statements and names of the generated
+     * subroutines are needed from now on, so the state used
+     * to build them is released before the next loop
+     * ======================================================
+     */
+
+    hostSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    userSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    delete kernelSubroutine;
+
+    Statistics::getInstance ()->endPhase ();
   }
 }
 
@@ -62,7 +62,8 @@ CPPCUDAKernelSubroutineDirectLoop::createUserSubroutineCallStatement ()
       Debug::getInstance ()->debugMessage ("Direct OP_DAT",
           Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
 
-      if (parallelLoop->getOpDatDimension (i) == 1)
+      if (parallelLoop->getOpDatDimension (i) == 1
+          && parallelLoop->isMixedPrecision (i) == false)
       {
         parameterExpression = buildAddOp (variableDeclarations->getReference (
             getOpDatName (i)), variableDeclarations->getReference (
@@ -192,9 +193,15 @@ CPPCUDAKernelSubroutineDirectLoop::createStageInFromSharedMemoryToLocalMemorySta
       variableDeclarations->getReference (sharedPointerVariableName),
       buildPointerType (parallelLoop->getOpDatBaseType (OP_DAT_ArgumentGroup)));
 
-  SgPntrArrRefExp * arrayExpression1 = buildPntrArrRefExp (castExpression1,
+  SgExpression * arrayExpression1 = buildPntrArrRefExp (castExpression1,
       addExpression1);
 
+  if (parallelLoop->isMixedPrecision (OP_DAT_ArgumentGroup))
+  {
+    arrayExpression1 = buildCastExp (arrayExpression1,
+        parallelLoop->getOpDatComputeType (OP_DAT_ArgumentGroup));
+  }
+
   SgPntrArrRefExp * arrayExpression2 = buildPntrArrRefExp (
       variableDeclarations->getReference (getOpDatLocalName (
           OP_DAT_ArgumentGroup)), variableDeclarations->getReference (
@@ -308,11 +315,17 @@ CPPCUDAKernelSubroutineDirectLoop::createStageOutFromLocalMemoryToSharedMemorySt
   SgPntrArrRefExp * arrayExpression1 = buildPntrArrRefExp (castExpression1,
       addExpression1);
 
-  SgPntrArrRefExp * arrayExpression2 = buildPntrArrRefExp (
+  SgExpression * arrayExpression2 = buildPntrArrRefExp (
       variableDeclarations->getReference (getOpDatLocalName (
           OP_DAT_ArgumentGroup)), variableDeclarations->getReference (
           getIterationCounterVariableName (2)));
 
+  if (parallelLoop->isMixedPrecision (OP_DAT_ArgumentGroup))
+  {
+    arrayExpression2 = buildCastExp (arrayExpression2,
+        parallelLoop->getOpDatBaseType (OP_DAT_ArgumentGroup));
+  }
+
   SgExprStatement * assignmentStatement1 = buildAssignStatement (
       arrayExpression1, arrayExpression2);
 
@@ -373,7 +386,8 @@ CPPCUDAKernelSubroutineDirectLoop::createExecutionLoopStatements ()
   for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
   {
     if (parallelLoop->isGlobal (i) == false && parallelLoop->isWritten (i)
-        == false && parallelLoop->getOpDatDimension (i) > 1)
+        == false && (parallelLoop->getOpDatDimension (i) > 1
+        || parallelLoop->isMixedPrecision (i)))
     {
       Debug::getInstance ()->debugMessage (
           "Creating statements to stage in from device memory to shared memory for OP_DAT "
@@ -398,7 +412,8 @@ CPPCUDAKernelSubroutineDirectLoop::createExecutionLoopStatements ()
   for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
   {
     if (parallelLoop->isGlobal (i) == false && parallelLoop->isRead (i)
-        == false && parallelLoop->getOpDatDimension (i) > 1)
+        == false && (parallelLoop->getOpDatDimension (i) > 1
+        || parallelLoop->isMixedPrecision (i)))
     {
       Debug::getInstance ()->debugMessage (
           "Creating statements to stage out from local memory to shared memory for OP_DAT "
@@ -541,14 +556,23 @@ CPPCUDAKernelSubroutineDirectLoop::createStageInVariableDeclarations ()
   {
     if (parallelLoop->isDuplicateOpDat (i) == false)
     {
-      if (parallelLoop->isDirect (i) && parallelLoop->getOpDatDimension (i) > 1)
+      /*
+       * ======================================================
+       * Mixed-precision OP_DATs are always staged through a
+       * local array of the type the user kernel computes in,
+       * converting on the way in and out
+       * ======================================================
+       */
+
+      if (parallelLoop->isDirect (i) && (parallelLoop->getOpDatDimension (i)
+          > 1 || parallelLoop->isMixedPrecision (i)))
       {
         string const & variableName = getOpDatLocalName (i);
 
         variableDeclarations ->add (variableName,
             RoseStatementsAndExpressionsBuilder::appendVariableDeclaration (
                 variableName, buildArrayType (
-                    parallelLoop->getOpDatBaseType (i), buildIntVal (
+                    parallelLoop->getOpDatComputeType (i), buildIntVal (
                         parallelLoop->getOpDatDimension (i))), subroutineScope));
       }
     }
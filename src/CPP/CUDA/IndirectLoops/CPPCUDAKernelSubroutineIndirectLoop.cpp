@@ -36,6 +36,37 @@
 #include "PlanFunctionNames.h"
 #include "OP2.h"
 #include "CUDA.h"
+#include "Globals.h"
+
+namespace
+{
+  /*
+   * ======================================================
+   * The OP2 access descriptor name used to instantiate the
+   * CUDA staging templates
+   * ======================================================
+   */
+  std::string
+  getAccessName (ParallelLoop * parallelLoop, unsigned int OP_DAT_ArgumentGroup)
+  {
+    if (parallelLoop->isIncremented (OP_DAT_ArgumentGroup))
+    {
+      return OP2::OP_INC;
+    }
+    else if (parallelLoop->isWritten (OP_DAT_ArgumentGroup))
+    {
+      return OP2::OP_WRITE;
+    }
+    else if (parallelLoop->isReadAndWritten (OP_DAT_ArgumentGroup))
+    {
+      return OP2::OP_RW;
+    }
+    else
+    {
+      return OP2::OP_READ;
+    }
+  }
+}
 
 SgStatement *
 CPPCUDAKernelSubroutineIndirectLoop::createUserSubroutineCallStatement ()
@@ -163,6 +194,23 @@ CPPCUDAKernelSubroutineIndirectLoop::createIncrementAndWriteAccessEpilogueStatem
         if (parallelLoop->isWritten (i) || parallelLoop->isReadAndWritten (i)
             || parallelLoop->isIncremented (i))
         {
+          if (Globals::getInstance ()->generateCUDATemplates ())
+          {
+            appendStatement (
+                CUDA::OP2RuntimeSupport::createStageOutCallStatement (
+                    subroutineScope, parallelLoop->getOpDatDimension (i),
+                    getAccessName (parallelLoop, i),
+                    variableDeclarations->getReference (getOpDatName (i)),
+                    variableDeclarations->getReference (
+                        getIndirectOpDatSharedMemoryName (i)),
+                    variableDeclarations->getReference (
+                        getIndirectOpDatMapName (i)),
+                    variableDeclarations->getReference (
+                        getIndirectOpDatSizeName (i))), block);
+
+            continue;
+          }
+
           /*
            * ======================================================
            * For loop body
@@ -291,6 +339,21 @@ CPPCUDAKernelSubroutineIndirectLoop::createStageOutFromLocalMemoryToSharedMemory
       SgMultiplyOp * multiplyExpression1 = buildMultiplyOp (arrayExpression1,
           buildIntVal (parallelLoop->getOpDatDimension (i)));
 
+      if (Globals::getInstance ()->generateCUDATemplates ())
+      {
+        SgAddOp * addExpression2 = buildAddOp (
+            variableDeclarations->getReference (
+                getIndirectOpDatSharedMemoryName (i)), multiplyExpression1);
+
+        appendStatement (
+            CUDA::OP2RuntimeSupport::createIncrementSharedCallStatement (
+                subroutineScope, parallelLoop->getOpDatDimension (i),
+                addExpression2, variableDeclarations->getReference (
+                    getOpDatLocalName (i))), ifBody);
+
+        continue;
+      }
+
       SgAddOp * addExpression2 = buildAddOp (
           variableDeclarations->getReference (getIterationCounterVariableName (
               2)), multiplyExpression1);
@@ -389,6 +452,17 @@ CPPCUDAKernelSubroutineIndirectLoop::createInitialiseIncrementAccessStatements (
           + lexical_cast <string> (i), Debug::HIGHEST_DEBUG_LEVEL, __FILE__,
           __LINE__);
 
+      if (Globals::getInstance ()->generateCUDATemplates ())
+      {
+        appendStatement (
+            CUDA::OP2RuntimeSupport::createZeroLocalCallStatement (
+                subroutineScope, parallelLoop->getOpDatDimension (i),
+                variableDeclarations->getReference (getOpDatLocalName (i))),
+            block);
+
+        continue;
+      }
+
       SgBasicBlock * loopBody = buildBasicBlock ();
 
       SgPntrArrRefExp * arrayExpression = buildPntrArrRefExp (
@@ -550,6 +624,23 @@ CPPCUDAKernelSubroutineIndirectLoop::createInitialiseCUDASharedVariablesStatemen
     {
       if (parallelLoop->isIndirect (i))
       {
+        if (Globals::getInstance ()->generateCUDATemplates ())
+        {
+          appendStatement (
+              CUDA::OP2RuntimeSupport::createStageInCallStatement (
+                  subroutineScope, parallelLoop->getOpDatDimension (i),
+                  getAccessName (parallelLoop, i),
+                  variableDeclarations->getReference (
+                      getIndirectOpDatSharedMemoryName (i)),
+                  variableDeclarations->getReference (getOpDatName (i)),
+                  variableDeclarations->getReference (
+                      getIndirectOpDatMapName (i)),
+                  variableDeclarations->getReference (
+                      getIndirectOpDatSizeName (i))), block);
+
+          continue;
+        }
+
         /*
          * ======================================================
          * For loop body
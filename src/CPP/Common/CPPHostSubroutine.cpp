@@ -191,5 +191,12 @@ CPPHostSubroutine::CPPHostSubroutine (SgScopeStatement * moduleScope,
 
   subroutineScope = subroutineHeaderStatement->get_definition ()->get_body ();
 
-  appendStatement (subroutineHeaderStatement, moduleScope);
+  /*
+   * ======================================================
+   * The subroutine is built detached from the module scope,
+   * into which it is inserted once every loop is built
+   * ======================================================
+   */
+
+  subroutineHeaderStatement->set_parent (moduleScope);
 }
@@ -47,5 +47,12 @@ CPPKernelSubroutine::CPPKernelSubroutine (SgScopeStatement * moduleScope,
 
   subroutineScope = subroutineHeaderStatement->get_definition ()->get_body ();
 
-  appendStatement (subroutineHeaderStatement, moduleScope);
+  /*
+   * ======================================================
+   * The subroutine is built detached from the module scope,
+   * into which it is inserted once every loop is built
+   * ======================================================
+   */
+
+  subroutineHeaderStatement->set_parent (moduleScope);
 }
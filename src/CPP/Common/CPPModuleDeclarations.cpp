@@ -35,6 +35,7 @@
 #include "CPPParallelLoop.h"
 #include "ScopedVariableDeclarations.h"
 #include "Debug.h"
+#include "Globals.h"
 #include "CompilerGeneratedNames.h"
 #include <rose.h>
 #include "OP2.h"
@@ -69,9 +70,24 @@ CPPModuleDeclarations::addParallelLoopSettingsVariables (
     std::string const & variableName1 = getBlockSizeVariableName (
         userSubroutineName);
 
+    /*
+     * ======================================================
+     * CUDA kernels are compiled with __launch_bounds__ set
+     * to the default block size, so the host must not be
+     * able to launch them with more threads than that
+     * ======================================================
+     */
+
+    SgType * blockSizeType = buildIntType ();
+
+    if (Globals::getInstance ()->getTargetBackend () == TargetLanguage::CUDA)
+    {
+      blockSizeType = buildConstType (buildIntType ());
+    }
+
     variableDeclaration1 = buildVariableDeclaration (
-        variableName1, buildIntType (), buildAssignInitializer (buildIntVal (
-            512), buildIntType ()), moduleScope);
+        variableName1, blockSizeType, buildAssignInitializer (buildIntVal (
+            OP2::defaultBlockSize), buildIntType ()), moduleScope);
 
     variableDeclarations ->add (variableName1, variableDeclaration1);
 
@@ -84,7 +100,7 @@ CPPModuleDeclarations::addParallelLoopSettingsVariables (
 
       SgVariableDeclaration * variableDeclaration2 = buildVariableDeclaration (
           variableName2, buildIntType (), buildAssignInitializer (buildIntVal (
-              512), buildIntType ()), moduleScope);
+              OP2::defaultPartitionSize), buildIntType ()), moduleScope);
 
       variableDeclarations ->add (variableName2, variableDeclaration2);
 
@@ -37,6 +37,7 @@
 #include "Debug.h"
 #include "Exceptions.h"
 #include "OP2.h"
+#include "OpenMP.h"
 
 void
 CPPPreProcess::visit (SgNode* node)
@@ -58,7 +59,9 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 {
 	using std::string;
 	using boost::iequals;
+	using SageInterface::addTextForUnparser;
 	using SageInterface::attachComment;
+	using SageInterface::copyExpression;
     using SageInterface::getScope;
     using SageInterface::insertStatement;
     using SageInterface::insertStatementListAfter;
@@ -188,7 +191,7 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 																		   declarations->getOpSetType (),
 																		   buildExprListExp (
 																							 buildVarRefExp (
-																											 name + "_count",
+																											 name + "_size",
 																											 scope
 																											 ),
 																							 buildStringVal (name + "_new")
@@ -213,12 +216,58 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 						  scope
 						  );
 	
+	/*
+	 * The subset is compacted only when it is reused and selects at most half
+	 * of the origin set: dense or one-shot subsets are cheaper to filter inline
+	 * than to compact, and loops over them then run on the origin set. Nothing
+	 * is allocated for a subset which is not compacted
+	 */
+	SgExpression * compactDecision = buildIntVal (0);
+	
+	if (subsetUses[name] > 1)
+	{
+		compactDecision =
+		buildLessOrEqualOp (
+							buildMultiplyOp (buildVarRefExp (name + "_count", scope), buildIntVal (2)),
+							buildVarRefExp (opOriginSet->getDimensionName (), scope));
+	}
+	
+	SgVariableDeclaration * compactvar =
+	buildVariableDeclaration (
+							  name + "_compact",
+							  buildIntType (),
+							  buildAssignInitializer (compactDecision, buildIntType ()),
+							  scope);
+	attachComment (compactvar, "Compact the subset if it is sparse and reused, filter it inline otherwise.");
+	
+	SgVariableDeclaration * sizevar =
+	buildVariableDeclaration (
+							  name + "_size",
+							  buildIntType (),
+							  buildAssignInitializer (
+													  buildConditionalExp (
+																		   buildVarRefExp (name + "_compact", scope),
+																		   buildVarRefExp (name + "_count", scope),
+																		   buildIntVal (0)),
+													  buildIntType ()),
+							  scope);
+	
 	SgVariableDeclaration* mapArray =
 	buildVariableDeclaration(
 							 "p_" + name,
 							 buildPointerType (buildIntType ()),
 							 buildAssignInitializer (
-													 ce,
+													 buildCastExp (
+																   buildFunctionCallExp (
+																						 SgName("malloc"),
+																						 buildPointerType (buildIntType ()),
+																						 buildExprListExp (
+																										   buildMultiplyOp (
+																															buildVarRefExp (name + "_size", scope),
+																															buildSizeOfOp (buildIntType ()))),
+																						 scope),
+																   buildPointerType (buildIntType ()),
+																   SgCastExp::e_C_style_cast),
 													 buildPointerType (buildIntType ())),
 							 scope);
 	
@@ -243,6 +292,112 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 							  scope);
 	
 	
+	/*
+	 * Compaction of the flagged elements into the subset map, as a parallel
+	 * prefix sum: the origin set is cut into chunks, the flagged elements of
+	 * every chunk are counted in parallel, the counts are scanned into chunk
+	 * offsets and every chunk then scatters its elements from its offset
+	 */
+	
+	int const numberOfChunks = 256;
+	
+	SgVariableDeclaration * bvar =
+	buildVariableDeclaration (
+							  name + "_b",
+							  buildIntType (),
+							  buildAssignInitializer (
+													  buildIntVal (0),
+													  buildIntType ()
+													  ),
+							  scope);
+	
+	SgVariableDeclaration * chunkvar =
+	buildVariableDeclaration (
+							  name + "_chunk",
+							  buildIntType (),
+							  buildAssignInitializer (
+													  buildDivideOp (
+																	 buildAddOp (
+																				 buildVarRefExp (opOriginSet->getDimensionName (), scope),
+																				 buildIntVal (numberOfChunks - 1)),
+																	 buildIntVal (numberOfChunks)),
+													  buildIntType ()
+													  ),
+							  scope);
+	
+	SgVariableDeclaration * offsetsArray =
+	buildVariableDeclaration(
+							 name + "_offsets",
+							 buildPointerType (buildIntType ()),
+							 buildAssignInitializer (
+													 buildCastExp (
+																   buildFunctionCallExp (
+																						 SgName("calloc"),
+																						 buildPointerType (buildIntType ()),
+																						 buildExprListExp (
+																										   buildIntVal (numberOfChunks + 1),
+																										   buildSizeOfOp (buildIntType ())),
+																						 scope),
+																   buildPointerType (buildIntType ()),
+																   SgCastExp::e_C_style_cast),
+													 buildPointerType (buildIntType ())),
+							 scope);
+	attachComment (offsetsArray, "Offsets of the chunks in the compacted subset.");
+	
+	SgExpression * chunkStart =
+	buildMultiplyOp (
+					 buildVarRefExp (name + "_b", scope),
+					 buildVarRefExp (name + "_chunk", scope));
+	
+	SgExpression * chunkEnd =
+	buildConditionalExp (
+						 buildLessThanOp (
+										  buildAddOp (copyExpression (chunkStart), buildVarRefExp (name + "_chunk", scope)),
+										  buildVarRefExp (opOriginSet->getDimensionName (), scope)),
+						 buildAddOp (copyExpression (chunkStart), buildVarRefExp (name + "_chunk", scope)),
+						 buildVarRefExp (opOriginSet->getDimensionName (), scope));
+	
+	SgForStatement* countLoop =
+	buildForStatement (
+					   buildAssignStatement (buildVarRefExp (name + "_b", scope), buildIntVal (0)),
+					   buildExprStatement (
+										   buildLessThanOp (
+															buildVarRefExp (name + "_b", scope),
+															buildIntVal (numberOfChunks))),
+					   buildPlusPlusOp (buildVarRefExp (name + "_b", scope)),
+					   buildForStatement (
+										  buildAssignStatement (buildVarRefExp (name + "_i", scope), copyExpression (chunkStart)),
+										  buildExprStatement (
+															  buildLessThanOp (
+																			   buildVarRefExp (name + "_i", scope),
+																			   copyExpression (chunkEnd))),
+										  buildPlusPlusOp (buildVarRefExp (name + "_i", scope)),
+										  buildExprStatement (
+															  buildPlusAssignOp (
+																				 buildPntrArrRefExp (
+																									 buildVarRefExp (name + "_offsets", scope),
+																									 buildAddOp (buildVarRefExp (name + "_b", scope), buildIntVal (1))),
+																				 buildPntrArrRefExp (
+																									 buildVarRefExp (name + "_flag", scope),
+																									 buildVarRefExp (name + "_i", scope))))));
+	
+	SgForStatement* scanLoop =
+	buildForStatement (
+					   buildAssignStatement (buildVarRefExp (name + "_b", scope), buildIntVal (0)),
+					   buildExprStatement (
+										   buildLessThanOp (
+															buildVarRefExp (name + "_b", scope),
+															buildIntVal (numberOfChunks))),
+					   buildPlusPlusOp (buildVarRefExp (name + "_b", scope)),
+					   buildExprStatement (
+										   buildPlusAssignOp (
+															  buildPntrArrRefExp (
+																				  buildVarRefExp (name + "_offsets", scope),
+																				  buildAddOp (buildVarRefExp (name + "_b", scope), buildIntVal (1))),
+															  buildPntrArrRefExp (
+																				  buildVarRefExp (name + "_offsets", scope),
+																				  buildVarRefExp (name + "_b", scope)))));
+	
 	SgStatement* loopBody =
 	buildIfStmt (
 				 buildExprStatement (
@@ -261,18 +416,40 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 				 NULL
 				 );
 	
-	SgForStatement* forLoop =
+	SgForStatement* scatterLoop =
 	buildForStatement (
-					   NULL,
+					   buildAssignStatement (buildVarRefExp (name + "_b", scope), buildIntVal (0)),
 					   buildExprStatement (
 										   buildLessThanOp (
-															buildVarRefExp(name + "_i" ,scope),
-															buildVarRefExp(opOriginSet->getDimensionName (), scope)
-															)),
-					   buildPlusPlusOp(buildVarRefExp(name + "_i" ,scope)),
-					   loopBody
-					   );
-	
+															buildVarRefExp (name + "_b", scope),
+															buildIntVal (numberOfChunks))),
+					   buildPlusPlusOp (buildVarRefExp (name + "_b", scope)),
+					   buildBasicBlock (
+										buildAssignStatement (
+															  buildVarRefExp (name + "_c", scope),
+															  buildPntrArrRefExp (
+																				  buildVarRefExp (name + "_offsets", scope),
+																				  buildVarRefExp (name + "_b", scope))),
+										buildForStatement (
+														   buildAssignStatement (buildVarRefExp (name + "_i", scope), copyExpression (chunkStart)),
+														   buildExprStatement (
+																			   buildLessThanOp (
+																								buildVarRefExp (name + "_i", scope),
+																								copyExpression (chunkEnd))),
+														   buildPlusPlusOp (buildVarRefExp (name + "_i", scope)),
+														   loopBody)));
+	
+	std::vector <SgVarRefExp *> chunkPrivateVariables;
+	chunkPrivateVariables.push_back (buildVarRefExp (name + "_i", scope));
+	chunkPrivateVariables.push_back (buildVarRefExp (name + "_c", scope));
+	
+	addTextForUnparser (countLoop,
+						OpenMP::getParallelLoopDirectiveString () + OpenMP::getPrivateClause (chunkPrivateVariables),
+						AstUnparseAttribute::e_before);
+	
+	addTextForUnparser (scatterLoop,
+						OpenMP::getParallelLoopDirectiveString () + OpenMP::getPrivateClause (chunkPrivateVariables),
+						AstUnparseAttribute::e_before);
 	
 	SgVariableDeclaration * mapDec =
 	buildVariableDeclaration (
@@ -301,11 +478,29 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 	block.push_back (subFlagDat);
 	block.push_back (buildExprStatement (filterLoopCall));
 	block.push_back (buildExprStatement (fetchFlag));
+	block.push_back (compactvar);
+	block.push_back (sizevar);
 	block.push_back (nSubSet);
 	block.push_back (mapArray);
 	block.push_back (ivar);
 	block.push_back (cvar);
-	block.push_back (forLoop);
+	block.push_back (bvar);
+	block.push_back (chunkvar);
+	block.push_back (
+					 buildIfStmt (
+								  buildVarRefExp (name + "_compact", scope),
+								  buildBasicBlock (
+												   offsetsArray,
+												   countLoop,
+												   scanLoop,
+												   scatterLoop,
+												   buildExprStatement (
+																	   buildFunctionCallExp (
+																							 SgName ("free"),
+																							 buildVoidType (),
+																							 buildExprListExp (buildVarRefExp (name + "_offsets", scope)),
+																							 scope))),
+								  NULL));
 	block.push_back (mapDec);
 	
 	
@@ -315,7 +510,7 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 		 it != declarations->lastOpMapDefinition ();
 		 ++it)
 	{
-		if (iequals (it->second->getSourceOpSetName (), originSetName))
+		if (iequals (it->second->getSourceOpSetName (), originSetName) && requiredMaps[name].count (it->first) > 0)
 		{
 			Debug::getInstance ()->debugMessage ("Collapsing mapping '" + it->second->getMappingName () + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 			
@@ -325,7 +520,7 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 												SgName("malloc"),
 												buildPointerType (buildIntType ()),
 												buildExprListExp (buildMultiplyOp (
-																				   buildVarRefExp (SgName (name + "_count"), scope),
+																				   buildVarRefExp (SgName (name + "_size"), scope),
 																				   buildMultiplyOp (
 																									buildIntVal (it->second->getDimension ()),
 																									buildSizeOfOp ( buildIntType ())))),
@@ -392,18 +587,31 @@ CPPPreProcess::generateSubsetDeclarationPrecomputedSubSet (std::string name, OpS
 					   buildExprStatement (
 										   buildLessThanOp (
 															buildVarRefExp(name + "_i" ,scope),
-															buildVarRefExp(name + "_count", scope)
+															buildVarRefExp(name + "_size", scope)
 															)),
 					   buildPlusPlusOp(buildVarRefExp(name + "_i" ,scope)),
 					   collapseLoopBody);
 	
-	block.push_back (collapseLoop);
+	/*
+	 * Every subset element fills its own entries of the collapsed maps
+	 */
+	std::vector <SgVarRefExp *> collapsePrivateVariables;
+	collapsePrivateVariables.push_back (buildVarRefExp (name + "_i", scope));
+	
+	addTextForUnparser (collapseLoop,
+						OpenMP::getParallelLoopDirectiveString () + OpenMP::getPrivateClause (collapsePrivateVariables),
+						AstUnparseAttribute::e_before);
+	
+	if (collapseLoopBodyStatements.empty () == false)
+	{
+		block.push_back (collapseLoop);
+	}
 	
 	for (std::map <string, OpMapDefinition *>::const_iterator it = declarations->firstOpMapDefinition ();
 		 it != declarations->lastOpMapDefinition ();
 		 ++it)
 	{
-		if (iequals (it->second->getSourceOpSetName (), originSetName))
+		if (iequals (it->second->getSourceOpSetName (), originSetName) && requiredMaps[name].count (it->first) > 0)
 		{
 			SgVariableDeclaration * collapseMapDec =
 			buildVariableDeclaration (
@@ -627,7 +835,7 @@ CPPPreProcess::handleOPParLoopInlineFilter (OpSubSetDefinition* opSubSet, SgFunc
 	// appending the extra op_arg_dat for evaluation the filter function
 	for (int i = 0; i < opSubSet->getNbFilterArg (); i++)
 	{
-		parLoop->get_args ()->get_expressions ().push_back (isSgFunctionCallExp (static_cast<CPPOxfordOpSubSetDefinition*> (opSubSet)->getOpArgDat (i)));
+		parLoop->get_args ()->get_expressions ().push_back (isSgFunctionCallExp (SageInterface::deepCopy (static_cast<CPPOxfordOpSubSetDefinition*> (opSubSet)->getOpArgDat (i))));
 	}
 }
 
@@ -643,6 +851,9 @@ CPPPreProcess::handleOPParLoopPrecomputedSubSet (OpSubSetDefinition* opSubSet, S
 
 	Debug::getInstance ()->debugMessage ("Patching op_par_loop on subset: '" + name + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 	
+	// loops over a subset sharing another one's precomputation use its set and maps
+	name = sharedSubsets[name];
+	
 	SgScopeStatement* scope = getScope (parLoop);
 	
 	parLoop->get_args ()->get_expressions ()[2] = 
@@ -681,17 +892,169 @@ CPPPreProcess::handleOPParLoopPrecomputedSubSet (OpSubSetDefinition* opSubSet, S
 	}
 }
 
+bool
+CPPPreProcess::isSameFilter (OpSubSetDefinition* first, OpSubSetDefinition* second)
+{
+	using SageInterface::getNextStatement;
+	
+	if (first->getOriginSetName () != second->getOriginSetName () ||
+		first->getFilterKernelName () != second->getFilterKernelName () ||
+		first->getNbFilterArg () != second->getNbFilterArg ())
+	{
+		return false;
+	}
+	
+	for (int i = 0; i < first->getNbFilterArg (); i++)
+	{
+		if (isSgExpression (static_cast<CPPOxfordOpSubSetDefinition*> (first)->getOpArgDat (i))->unparseToString () !=
+			isSgExpression (static_cast<CPPOxfordOpSubSetDefinition*> (second)->getOpArgDat (i))->unparseToString ())
+		{
+			return false;
+		}
+	}
+	
+	/*
+	 * The filter data must also be unchanged between the two declarations,
+	 * which is only assumed when nothing but declarations separates them
+	 */
+	SgStatement* secondDeclaration = static_cast<CPPOxfordOpSubSetDefinition*> (second)->getSubsetDeclaration ();
+	
+	for (SgStatement* statement = getNextStatement (static_cast<CPPOxfordOpSubSetDefinition*> (first)->getSubsetDeclaration ());
+		 statement != NULL;
+		 statement = getNextStatement (statement))
+	{
+		if (statement == secondDeclaration)
+		{
+			return true;
+		}
+		
+		if (isSgVariableDeclaration (statement) == NULL)
+		{
+			return false;
+		}
+	}
+	
+	return false;
+}
+
+void
+CPPPreProcess::findSharedSubsets ()
+{
+	using std::string;
+	
+	for (std::map <string, OpSubSetDefinition *>::const_iterator it = declarations->firstOpSubSetDefinition ();
+		 it != declarations->lastOpSubSetDefinition ();
+		 ++it)
+	{
+		// walk back to the first of the equivalent subsets declared before this one
+		string shared = it->first;
+		
+		bool found = true;
+		
+		while (found)
+		{
+			found = false;
+			
+			for (std::map <string, OpSubSetDefinition *>::const_iterator jt = declarations->firstOpSubSetDefinition ();
+				 jt != declarations->lastOpSubSetDefinition ();
+				 ++jt)
+			{
+				if (jt->first != shared && isSameFilter (jt->second, declarations->getOpSubSetDefinition (shared)))
+				{
+					shared = jt->first;
+					found = true;
+					break;
+				}
+			}
+		}
+		
+		sharedSubsets[it->first] = shared;
+		
+		requiredMaps[shared];
+		
+		if (shared != it->first)
+		{
+			Debug::getInstance ()->debugMessage ("Subset '" + it->first + "' shares the precomputed subset '" + shared + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+		}
+	}
+}
+
+void
+CPPPreProcess::findRequiredMaps ()
+{
+	using boost::iequals;
+	using std::map;
+	using std::vector;
+	using std::string;
+	
+	for (map <string, ParallelLoop *>::const_iterator it =
+		 declarations->firstParallelLoop (); it
+		 != declarations->lastParallelLoop (); ++it)
+	{
+		for (vector <SgFunctionCallExp *>::const_iterator fit =
+			 it->second->getFirstFunctionCall (); fit
+			 != it->second->getLastFunctionCall (); ++fit)
+		{
+			string name = isSgVarRefExp ((*fit)->get_args ()->get_expressions ()[2])->get_symbol ()->get_name ().getString ();
+			
+			if (declarations->isOpSubSet (name) == false)
+			{
+				continue;
+			}
+			
+			/*
+			 * A loop enclosed by an iteration statement, itself within the
+			 * scope declaring the subset, runs over the subset repeatedly
+			 */
+			SgScopeStatement * subsetScope = static_cast<CPPOxfordOpSubSetDefinition*> (declarations->getOpSubSetDefinition (sharedSubsets[name]))->getSubsetDeclaration ()->get_scope ();
+			
+			int uses = 1;
+			
+			for (SgNode * node = (*fit)->get_parent (); node != NULL && node != subsetScope; node = node->get_parent ())
+			{
+				if (isSgForStatement (node) != NULL || isSgWhileStmt (node) != NULL || isSgDoWhileStmt (node) != NULL)
+				{
+					uses = 2;
+					break;
+				}
+			}
+			
+			subsetUses[sharedSubsets[name]] += uses;
+			
+			for (unsigned int i = 3; i < (*fit)->get_args ()->get_expressions ().size (); i++)
+			{
+				SgFunctionCallExp * opArg = isSgFunctionCallExp ((*fit)->get_args ()->get_expressions ()[i]);
+				
+				if (opArg != NULL && iequals (opArg->getAssociatedFunctionSymbol ()->get_name ().getString (), OP2::OP_ARG_DAT) &&
+					isSgVarRefExp (opArg->get_args ()->get_expressions ()[2]) != NULL)
+				{
+					requiredMaps[sharedSubsets[name]].insert (isSgVarRefExp (opArg->get_args ()->get_expressions ()[2])->get_symbol ()->get_name ().getString ());
+				}
+			}
+		}
+	}
+}
+
 void
 CPPPreProcess::handleSubsetDeclarations ()
 {
 	using std::map;
 	using std::vector;
 	using std::string;
+	using SageInterface::removeStatement;
 	
 	for (std::map <string, OpSubSetDefinition *>::const_iterator it = declarations->firstOpSubSetDefinition ();
 		 it != declarations->lastOpSubSetDefinition ();
 		 ++it)
 	{
+		if (precompute && sharedSubsets[it->first] != it->first)
+		{
+			// nothing to build: loops over this subset are redirected to the shared one
+			removeStatement (isSgStatement (static_cast<CPPOxfordOpSubSetDefinition*> (it->second)->getSubsetDeclaration ()), false);
+			
+			continue;
+		}
+		
 		// must do filter function wrapper first to have the filter func definition at hand for the subset op_par_loop creation
 		Debug::getInstance ()->debugMessage ("generating filter function wrapper for '" + it->second->getFilterKernelName () + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 		
@@ -720,7 +1083,9 @@ CPPPreProcess::handleOPParLoops ()
 	using std::map;
 	using std::vector;
 	using std::string;
+	using SageInterface::deepCopy;
 	using SageInterface::getScope;
+	using SageInterface::replaceStatement;
 	using namespace SageBuilder;
 
 	
@@ -749,7 +1114,24 @@ CPPPreProcess::handleOPParLoops ()
 				
 				if (precompute)
 				{
-					handleOPParLoopPrecomputedSubSet (opSubSet, *fit);
+					// both versions of the loop are kept, the subset construction deciding which one runs
+					SgStatement * parLoopStatement = isSgStatement ((*fit)->get_parent ());
+					
+					SgExprStatement * precomputedStatement = isSgExprStatement (deepCopy (parLoopStatement));
+					
+					SgExprStatement * inlineFilterStatement = isSgExprStatement (deepCopy (parLoopStatement));
+					
+					replaceStatement (
+									  parLoopStatement,
+									  buildIfStmt (
+												   buildVarRefExp (sharedSubsets[name] + "_compact", getScope (parLoopStatement)),
+												   precomputedStatement,
+												   inlineFilterStatement),
+									  true);
+					
+					handleOPParLoopPrecomputedSubSet (opSubSet, isSgFunctionCallExp (precomputedStatement->get_expression ()));
+					
+					handleOPParLoopInlineFilter (opSubSet, isSgFunctionCallExp (inlineFilterStatement->get_expression ()));
 				} else {
 					handleOPParLoopInlineFilter (opSubSet, *fit);
 				}
@@ -771,6 +1153,8 @@ CPPPreProcess::CPPPreProcess (SgProject* project, CPPProgramDeclarationsAndDefin
 	*/
 	
     Debug::getInstance ()->debugMessage ("Preprocessing OP2 code'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+	findSharedSubsets ();
+	findRequiredMaps ();
 	handleSubsetDeclarations ();
 	handleOPParLoops ();
 //	traverse (project, postorder);
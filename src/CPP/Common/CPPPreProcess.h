@@ -34,6 +34,8 @@
 #ifndef CPP_PREPROCESS_H
 #define CPP_PREPROCESS_H
 
+#include <map>
+#include <set>
 #include <rose.h>
 #include "OP2Definitions.h"
 
@@ -51,6 +53,24 @@ class CPPPreProcess: public AstSimpleProcessing
 	SgSourceFile* sourceFile;
     
     CPPProgramDeclarationsAndDefinitions* declarations;
+	
+	/*
+	 * For every subset, the subset whose precomputed set and maps it uses:
+	 * itself, or an earlier subset built with the same filter
+	 */
+	std::map <std::string, std::string> sharedSubsets;
+	
+	/*
+	 * For every subset built, the maps of its origin set used by loops over
+	 * the subsets sharing it, which are the only ones collapsed
+	 */
+	std::map <std::string, std::set <std::string> > requiredMaps;
+	
+	/*
+	 * For every subset built, how many loops are expected to run over it; a
+	 * loop nested in an iteration statement counts as several
+	 */
+	std::map <std::string, int> subsetUses;
     
     virtual void
     visit (SgNode* node);
@@ -67,6 +87,15 @@ class CPPPreProcess: public AstSimpleProcessing
 	void
 	generateKernelInlinedFilter (OpSubSetDefinition* opSubSet, SgFunctionCallExp * parLoop);
 	
+	bool
+	isSameFilter (OpSubSetDefinition* first, OpSubSetDefinition* second);
+	
+	void
+	findSharedSubsets ();
+	
+	void
+	findRequiredMaps ();
+	
 	void
 	handleSubsetDeclarations ();
 
@@ -34,10 +34,232 @@
 #include "CPPOP2Definitions.h"
 #include "CPPParallelLoop.h"
 #include "Exceptions.h"
+#include "Globals.h"
 #include "OP2.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <fstream>
+
+void
+CPPProgramDeclarationsAndDefinitions::readPrecisionPolicy ()
+{
+  using namespace SageBuilder;
+  using boost::trim_copy;
+  using std::ifstream;
+  using std::string;
+
+  /*
+   * ======================================================
+   * Each line has the form 'op_dat=float' or 'op_dat=double';
+   * empty lines and lines starting with '#' are ignored
+   * ======================================================
+   */
+
+  string const & fileName =
+      Globals::getInstance ()->getPrecisionPolicyFileName ();
+
+  if (fileName.empty ())
+  {
+    return;
+  }
+
+  ifstream inputFile (fileName.c_str ());
+
+  if (inputFile.is_open () == false)
+  {
+    throw Exceptions::ASTParsing::NoSourceFileException (
+        "Unable to open precision policy file '" + fileName + "'");
+  }
+
+  string line;
+
+  while (getline (inputFile, line))
+  {
+    line = trim_copy (line);
+
+    size_t const separator = line.find ('=');
+
+    if (line.empty () || line[0] == '#' || separator == string::npos)
+    {
+      continue;
+    }
+
+    string const opDatName = trim_copy (line.substr (0, separator));
+
+    string const precision = trim_copy (line.substr (separator + 1));
+
+    if (precision == "float")
+    {
+      precisionPolicy[opDatName] = buildFloatType ();
+    }
+    else if (precision == "double")
+    {
+      precisionPolicy[opDatName] = buildDoubleType ();
+    }
+    else
+    {
+      throw Exceptions::ParallelLoop::UnsupportedBaseTypeException (
+          "Precision '" + precision + "' requested for OP_DAT '" + opDatName
+              + "' is neither float nor double");
+    }
+
+    Debug::getInstance ()->debugMessage ("OP_DAT '" + opDatName
+        + "' will be computed on in " + precision, Debug::VERBOSE_LEVEL,
+        __FILE__, __LINE__);
+  }
+}
+
+void
+CPPProgramDeclarationsAndDefinitions::readSetSizes ()
+{
+  using boost::lexical_cast;
+  using boost::bad_lexical_cast;
+  using boost::trim_copy;
+  using std::ifstream;
+  using std::string;
+
+  /*
+   * ======================================================
+   * Each line has the form 'op_set=size'; empty lines and
+   * lines starting with '#' are ignored
+   * ======================================================
+   */
+
+  string const & fileName = Globals::getInstance ()->getSetSizesFileName ();
+
+  if (fileName.empty ())
+  {
+    return;
+  }
+
+  ifstream inputFile (fileName.c_str ());
+
+  if (inputFile.is_open () == false)
+  {
+    throw Exceptions::ASTParsing::NoSourceFileException (
+        "Unable to open set sizes file '" + fileName + "'");
+  }
+
+  string line;
+
+  while (getline (inputFile, line))
+  {
+    line = trim_copy (line);
+
+    size_t const separator = line.find ('=');
+
+    if (line.empty () || line[0] == '#' || separator == string::npos)
+    {
+      continue;
+    }
+
+    string const opSetName = trim_copy (line.substr (0, separator));
+
+    string const size = trim_copy (line.substr (separator + 1));
+
+    try
+    {
+      opSetSizes[opSetName] = lexical_cast <unsigned int> (size);
+    }
+    catch (bad_lexical_cast const &)
+    {
+      throw Exceptions::CommandLine::LanguageException ("Size '" + size
+          + "' given for OP_SET '" + opSetName + "' is not an integer");
+    }
+
+    Debug::getInstance ()->debugMessage ("OP_SET '" + opSetName
+        + "' has size " + size, Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+  }
+}
+
+void
+CPPProgramDeclarationsAndDefinitions::recordStaticSetSize (
+    OpSetDefinition * opSetDeclaration, SgExprListExp * actualArguments)
+{
+  using boost::lexical_cast;
+  using std::string;
+
+  /*
+   * ======================================================
+   * A size given in the set sizes file takes precedence.
+   * Otherwise the size is known if the variable passed to
+   * OP_DECL_SET is a constant initialised with a literal
+   * ======================================================
+   */
+
+  if (opSetSizes.count (opSetDeclaration->getVariableName ()) > 0)
+  {
+    return;
+  }
+
+  SgExpressionPtrList & expressions = actualArguments->get_expressions ();
+
+  for (SgExpressionPtrList::iterator it = expressions.begin (); it
+      != expressions.end (); ++it)
+  {
+    SgVarRefExp * sizeReference = isSgVarRefExp (*it);
+
+    if (sizeReference == NULL || sizeReference->get_symbol ()->get_name ().getString ()
+        != opSetDeclaration->getDimensionName ())
+    {
+      continue;
+    }
+
+    SgInitializedName * sizeDeclaration =
+        sizeReference->get_symbol ()->get_declaration ();
+
+    SgAssignInitializer * initializer = isSgAssignInitializer (
+        sizeDeclaration->get_initializer ());
+
+    if (SageInterface::isConstType (sizeDeclaration->get_type ())
+        && initializer != NULL && isSgIntVal (initializer->get_operand ()))
+    {
+      int const size = isSgIntVal (initializer->get_operand ())->get_value ();
+
+      if (size > 0)
+      {
+        opSetSizes[opSetDeclaration->getVariableName ()] = size;
+
+        Debug::getInstance ()->debugMessage ("OP_SET '"
+            + opSetDeclaration->getVariableName () + "' has constant size "
+            + lexical_cast <string> (size), Debug::VERBOSE_LEVEL, __FILE__,
+            __LINE__);
+      }
+    }
+
+    return;
+  }
+}
+
+unsigned int
+CPPProgramDeclarationsAndDefinitions::getIterationSetSize (
+    SgExprListExp * actualArguments)
+{
+  using std::string;
+
+  /*
+   * ======================================================
+   * The iteration set follows the user subroutine, and the
+   * kernel name string in the Oxford API
+   * ======================================================
+   */
+
+  SgExpressionPtrList & expressions = actualArguments->get_expressions ();
+
+  for (unsigned int i = 1; i < 3 && i < expressions.size (); ++i)
+  {
+    SgVarRefExp * opSetReference = isSgVarRefExp (expressions[i]);
+
+    if (opSetReference != NULL)
+    {
+      return getOpSetSize (opSetReference->get_symbol ()->get_name ().getString ());
+    }
+  }
+
+  return 0;
+}
 
 void
 CPPProgramDeclarationsAndDefinitions::setOpGblProperties (
@@ -68,6 +290,12 @@ CPPProgramDeclarationsAndDefinitions::setOpDatProperties (
 
   parallelLoop->setOpDatVariableName (OP_DAT_ArgumentGroup, variableName);
 
+  if (precisionPolicy.find (variableName) != precisionPolicy.end ())
+  {
+    parallelLoop->setOpDatComputeType (OP_DAT_ArgumentGroup,
+        precisionPolicy[variableName]);
+  }
+
   if (parallelLoop->isUniqueOpDat (variableName))
   {
     parallelLoop->setUniqueOpDat (variableName);
@@ -273,6 +501,9 @@ CPPProgramDeclarationsAndDefinitions::handleImperialOpDatArgument (
         Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
 
     parallelLoop->setOpMapValue (OP_DAT_ArgumentGroup, INDIRECT);
+
+    parallelLoop->setOpMapVariableName (OP_DAT_ArgumentGroup, isSgVarRefExp (
+        actualArguments->get_expressions ()[CPPImperialOpArgDatCall::indexOpMap])->get_symbol ()->get_name ().getString ());
   }
 }
 
@@ -315,6 +546,9 @@ CPPProgramDeclarationsAndDefinitions::handleOxfordOpDatArgument (
         Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
 
     parallelLoop->setOpMapValue (OP_DAT_ArgumentGroup, INDIRECT);
+
+    parallelLoop->setOpMapVariableName (OP_DAT_ArgumentGroup, isSgVarRefExp (
+        actualArguments->get_expressions ()[CPPImperialOpArgDatCall::indexOpMap])->get_symbol ()->get_name ().getString ());
   }
 }
 
@@ -444,6 +678,8 @@ CPPProgramDeclarationsAndDefinitions::detectAndHandleOP2Definition (
       }
     }
     OpSetDefinitions[opSetDeclaration->getVariableName ()] = opSetDeclaration;
+
+    recordStaticSetSize (opSetDeclaration, functionCallExpression->get_args ());
   }
   else if (iequals (typeName, OP2::OP_MAP))
   {
@@ -524,6 +760,8 @@ CPPProgramDeclarationsAndDefinitions::visit (SgNode * node)
   using boost::iequals;
   using std::string;
 
+  ++numberOfVisitedNodes;
+
   switch (node->variantT ())
   {
     case V_SgSourceFile:
@@ -702,6 +940,8 @@ CPPProgramDeclarationsAndDefinitions::visit (SgNode * node)
             + "' with (host) user subroutine '" + userSubroutineName + "'",
             Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
 
+        registerUserSubroutine (functionRefExpression);
+
         if (parallelLoops.find (userSubroutineName) == parallelLoops.end ())
         {
           /*
@@ -721,6 +961,9 @@ CPPProgramDeclarationsAndDefinitions::visit (SgNode * node)
           analyseParallelLoopArguments (parallelLoop, actualArguments);
 
           parallelLoop->checkArguments ();
+
+          parallelLoop->setIterationSetSize (getIterationSetSize (
+              actualArguments));
         }
         else
         {
@@ -733,6 +976,9 @@ CPPProgramDeclarationsAndDefinitions::visit (SgNode * node)
           parallelLoop->addFunctionCallExpression (functionCallExp);
 
           parallelLoop->addFileName (currentSourceFile);
+
+          parallelLoop->mergeIterationSetSize (getIterationSetSize (
+              actualArguments));
         }
 
       }
@@ -783,34 +1029,169 @@ CPPProgramDeclarationsAndDefinitions::visit (SgNode * node)
   }
 }
 
+SgType *
+CPPProgramDeclarationsAndDefinitions::lookupOP2Type (SgType * & type,
+    std::string const & typeName)
+{
+  using namespace SageInterface;
+
+  if (type == NULL)
+  {
+    SgTypedefSymbol * symbol = lookupTypedefSymbolInParentScopes (typeName,
+        getFirstGlobalScope (project));
+
+    if (symbol != NULL)
+    {
+      Debug::getInstance ()->debugMessage ("Registering type reference for '"
+          + typeName + "' from the global scope", Debug::OUTER_LOOP_LEVEL,
+          __FILE__, __LINE__);
+
+      type = symbol->get_declaration ()->get_type ();
+    }
+  }
+
+  return type;
+}
+
+void
+CPPProgramDeclarationsAndDefinitions::registerUserSubroutine (
+    SgFunctionRefExp * functionReference)
+{
+  using std::string;
+
+  /*
+   * ======================================================
+   * User kernels are usually defined in a header, which is
+   * not scanned. The kernel is reached through its symbol
+   * instead, preferring its defining declaration over any
+   * prototype
+   * ======================================================
+   */
+
+  SgFunctionDeclaration * functionDeclaration =
+      functionReference->getAssociatedFunctionDeclaration ();
+
+  string const functionName = functionDeclaration->get_name ().getString ();
+
+  SgFunctionDeclaration * definingDeclaration = isSgFunctionDeclaration (
+      functionDeclaration->get_definingDeclaration ());
+
+  if (definingDeclaration == NULL)
+  {
+    return;
+  }
+
+  if (subroutinesInSourceCode.count (functionName) == 0
+      || subroutinesInSourceCode[functionName]->get_definition () == NULL)
+  {
+    Debug::getInstance ()->debugMessage ("Registering user subroutine '"
+        + functionName + "' from its definition in '"
+        + definingDeclaration->get_file_info ()->get_filenameString () + "'",
+        Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
+
+    subroutinesInSourceCode[functionName] = definingDeclaration;
+  }
+}
+
 CPPProgramDeclarationsAndDefinitions::CPPProgramDeclarationsAndDefinitions (
-    SgProject * project)
+    SgProject * project) :
+  op_dat_type (NULL), op_set_type (NULL), op_map_type (NULL),
+      op_access_type (NULL), opAccessEnumDeclaration (NULL), project (project),
+      numberOfVisitedNodes (0)
 {
-  traverse (project, preorder);
+  using boost::lexical_cast;
+  using boost::posix_time::ptime;
+  using boost::posix_time::microsec_clock;
+  using std::string;
+
+  readPrecisionPolicy ();
+
+  readSetSizes ();
+
+  /*
+   * ======================================================
+   * Only the nodes of the input files are visited: the
+   * system, Boost and OP2 headers pulled into each file
+   * make up most of the AST but declare nothing the
+   * generators need apart from what is looked up lazily
+   * ======================================================
+   */
+
+  ptime const start = microsec_clock::local_time ();
+
+  SgFilePtrList & files = project->get_fileList ();
+
+  for (SgFilePtrList::iterator it = files.begin (); it != files.end (); ++it)
+  {
+    SgSourceFile * sourceFile = isSgSourceFile (*it);
+
+    if (sourceFile != NULL)
+    {
+      visit (sourceFile);
+
+      /*
+       * ======================================================
+       * Access descriptors are decoded through the 'op_access'
+       * enumeration, which must be seen before any
+       * OP_PAR_LOOP
+       * ======================================================
+       */
+
+      SgEnumSymbol * opAccessSymbol =
+          SageInterface::lookupEnumSymbolInParentScopes (OP2::OP_ACCESS,
+              sourceFile->get_globalScope ());
+
+      if (opAccessEnumDeclaration == NULL && opAccessSymbol != NULL)
+      {
+        SgEnumDeclaration * enumDeclaration = isSgEnumDeclaration (
+            opAccessSymbol->get_declaration ()->get_definingDeclaration ());
+
+        visit (enumDeclaration != NULL ? enumDeclaration
+            : opAccessSymbol->get_declaration ());
+      }
+
+      traverseWithinFile (sourceFile, preorder);
+    }
+  }
+
+  Debug::getInstance ()->debugMessage ("Declaration scan visited "
+      + lexical_cast <string> (numberOfVisitedNodes) + " nodes in "
+      + lexical_cast <string> ((microsec_clock::local_time () - start).total_milliseconds ())
+      + " ms", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+}
+
+unsigned int
+CPPProgramDeclarationsAndDefinitions::getOpSetSize (
+    std::string const & opSetName)
+{
+  std::map <std::string, unsigned int>::const_iterator it = opSetSizes.find (
+      opSetName);
+
+  return it == opSetSizes.end () ? 0 : it->second;
 }
 
 SgType *
 CPPProgramDeclarationsAndDefinitions::getOpDatType ()
 {
-    return op_dat_type;
+    return lookupOP2Type (op_dat_type, OP2::OP_DAT);
 }
 
 SgType *
 CPPProgramDeclarationsAndDefinitions::getOpSetType ()
 {
-    return op_set_type;
+    return lookupOP2Type (op_set_type, OP2::OP_SET);
 }
 
 SgType *
 CPPProgramDeclarationsAndDefinitions::getOpMapType ()
 {
-    return op_map_type;
+    return lookupOP2Type (op_map_type, OP2::OP_MAP);
 }
 
 SgType *
 CPPProgramDeclarationsAndDefinitions::getOpAccessType ()
 {
-    return op_access_type;
+    return lookupOP2Type (op_access_type, OP2::OP_ACCESS);
 }
 
 SgEnumDeclaration *
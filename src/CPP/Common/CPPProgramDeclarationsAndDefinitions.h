@@ -52,8 +52,49 @@ class CPPProgramDeclarationsAndDefinitions: public ProgramDeclarationsAndDefinit
     SgType * op_access_type;
     SgEnumDeclaration * opAccessEnumDeclaration;
 
+    /*
+     * ======================================================
+     * Only the input files are scanned, so the OP2 types and
+     * user kernels declared in headers are looked up in the
+     * global scope of the project when they are needed
+     * ======================================================
+     */
+    SgProject * project;
+
+    unsigned int numberOfVisitedNodes;
+
+    /*
+     * ======================================================
+     * The precision in which kernels compute on each OP_DAT
+     * named in the precision policy file
+     * ======================================================
+     */
+    std::map <std::string, SgType *> precisionPolicy;
+
+    /*
+     * ======================================================
+     * The size of each OP_SET known before the program runs,
+     * either given in the set sizes file or declared through
+     * a constant
+     * ======================================================
+     */
+    std::map <std::string, unsigned int> opSetSizes;
+
   private:
 
+    void
+    readPrecisionPolicy ();
+
+    void
+    readSetSizes ();
+
+    void
+    recordStaticSetSize (OpSetDefinition * opSetDeclaration,
+        SgExprListExp * actualArguments);
+
+    unsigned int
+    getIterationSetSize (SgExprListExp * actualArguments);
+
     void
     setOpGblProperties (CPPParallelLoop * parallelLoop,
         std::string const & variableName, int OP_DAT_ArgumentGroup);
@@ -91,12 +132,27 @@ class CPPProgramDeclarationsAndDefinitions: public ProgramDeclarationsAndDefinit
     detectAndHandleOP2Definition (SgVariableDeclaration * variableDeclaration,
         std::string const variableName, SgTypedefType * typeDefinition);
 
+    SgType *
+    lookupOP2Type (SgType * & type, std::string const & typeName);
+
+    void
+    registerUserSubroutine (SgFunctionRefExp * functionReference);
+
     virtual void
     visit (SgNode * node);
 
   public:
 
     CPPProgramDeclarationsAndDefinitions (SgProject * project);
+
+    /*
+     * ======================================================
+     * The size of this OP_SET, or zero if it is not known
+     * before the program runs
+     * ======================================================
+     */
+    unsigned int
+    getOpSetSize (std::string const & opSetName);
     
     SgType *
     getOpDatType ();
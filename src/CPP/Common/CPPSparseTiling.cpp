@@ -0,0 +1,968 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "CPPSparseTiling.h"
+#include "CPPProgramDeclarationsAndDefinitions.h"
+#include "Debug.h"
+#include "OP2.h"
+
+#include "Globals.h"
+
+#include <iostream>
+
+void
+CPPSparseTiling::visit (SgNode * node)
+{
+  SgBasicBlock * basicBlock = isSgBasicBlock (node);
+
+  if (basicBlock != NULL)
+  {
+    basicBlocks.push_back (basicBlock);
+  }
+}
+
+SgFunctionCallExp *
+CPPSparseTiling::getParallelLoopCall (SgStatement * statement)
+{
+  using boost::iequals;
+
+  SgExprStatement * expressionStatement = isSgExprStatement (statement);
+
+  if (expressionStatement == NULL)
+  {
+    return NULL;
+  }
+
+  SgFunctionCallExp * functionCallExp = isSgFunctionCallExp (
+      expressionStatement->get_expression ());
+
+  if (functionCallExp == NULL
+      || functionCallExp->getAssociatedFunctionSymbol () == NULL
+      || iequals (
+          functionCallExp->getAssociatedFunctionSymbol ()->get_name ().getString (),
+          OP2::OP_PAR_LOOP) == false)
+  {
+    return NULL;
+  }
+
+  return functionCallExp;
+}
+
+SgFunctionDeclaration *
+CPPSparseTiling::getUserSubroutine (SgFunctionCallExp * parallelLoopCall)
+{
+  SgFunctionRefExp * functionRefExpression = isSgFunctionRefExp (
+      parallelLoopCall->get_args ()->get_expressions ().front ());
+
+  if (functionRefExpression == NULL)
+  {
+    return NULL;
+  }
+
+  SgFunctionDeclaration * subroutine =
+      functionRefExpression->getAssociatedFunctionDeclaration ();
+
+  if (subroutine->get_definingDeclaration () != NULL)
+  {
+    return isSgFunctionDeclaration (subroutine->get_definingDeclaration ());
+  }
+
+  return subroutine;
+}
+
+bool
+CPPSparseTiling::isIndirect (SgFunctionCallExp * parallelLoopCall)
+{
+  using boost::iequals;
+
+  SgExpressionPtrList const & arguments =
+      parallelLoopCall->get_args ()->get_expressions ();
+
+  for (unsigned int i = indexFirstOpArg; i < arguments.size (); ++i)
+  {
+    SgFunctionCallExp * opArgCall = isSgFunctionCallExp (arguments[i]);
+
+    if (iequals (
+        opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+        OP2::OP_ARG_DAT) && isSgVarRefExp (
+        opArgCall->get_args ()->get_expressions ()[2]) != NULL)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+CPPSparseTiling::isHoistable (SgStatement * statement,
+    std::vector <SgFunctionCallExp *> const & chain)
+{
+  using std::vector;
+
+  /*
+   * ======================================================
+   * A statement between two loops of a chain, such as the
+   * reset of a reduction variable, does not break the chain
+   * if it assigns a constant to a variable none of the
+   * loops seen so far accesses: it can then be moved in
+   * front of the executor
+   * ======================================================
+   */
+
+  SgExprStatement * expressionStatement = isSgExprStatement (statement);
+
+  if (expressionStatement == NULL)
+  {
+    return false;
+  }
+
+  SgAssignOp * assignment = isSgAssignOp (expressionStatement->get_expression ());
+
+  if (assignment == NULL || isSgValueExp (assignment->get_rhs_operand ())
+      == NULL)
+  {
+    return false;
+  }
+
+  SgVarRefExp * variableReference = isSgVarRefExp (
+      assignment->get_lhs_operand ());
+
+  if (variableReference == NULL)
+  {
+    return false;
+  }
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    Rose_STL_Container <SgNode *> references = NodeQuery::querySubTree (*it,
+        V_SgVarRefExp);
+
+    for (Rose_STL_Container <SgNode *>::const_iterator reference =
+        references.begin (); reference != references.end (); ++reference)
+    {
+      if (isSgVarRefExp (*reference)->get_symbol ()
+          == variableReference->get_symbol ())
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool
+CPPSparseTiling::isTilingLegal (
+    std::vector <SgFunctionCallExp *> const & chain,
+    SgFunctionCallExp * candidate, std::string & reason)
+{
+  using boost::iequals;
+  using boost::lexical_cast;
+  using boost::bad_lexical_cast;
+  using std::string;
+  using std::vector;
+
+  /*
+   * ======================================================
+   * The executor calls the user kernel itself, so every
+   * argument must be given through an OP_ARG call, indirect
+   * arguments must use a declared mapping with a fixed
+   * index, and the kernel must take one parameter per
+   * argument
+   * ======================================================
+   */
+
+  SgExpressionPtrList const & arguments =
+      candidate->get_args ()->get_expressions ();
+
+  if (isSgVarRefExp (arguments[indexOpSet]) == NULL)
+  {
+    reason = "iteration set is not a variable";
+    return false;
+  }
+
+  SgFunctionDeclaration * subroutine = getUserSubroutine (candidate);
+
+  if (subroutine == NULL || subroutine->get_args ().size ()
+      != arguments.size () - indexFirstOpArg)
+  {
+    reason = "kernel signature does not match its arguments";
+    return false;
+  }
+
+  for (unsigned int i = indexFirstOpArg; i < arguments.size (); ++i)
+  {
+    SgFunctionCallExp * opArgCall = isSgFunctionCallExp (arguments[i]);
+
+    if (opArgCall == NULL || opArgCall->getAssociatedFunctionSymbol () == NULL)
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+
+    string const opArgName =
+        opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString ();
+
+    SgExpressionPtrList const & opArgArguments =
+        opArgCall->get_args ()->get_expressions ();
+
+    if (iequals (opArgName, OP2::OP_ARG_DAT))
+    {
+      SgVarRefExp * mapReference = isSgVarRefExp (opArgArguments[2]);
+
+      if (mapReference != NULL)
+      {
+        try
+        {
+          declarations->getOpMapDefinition (
+              mapReference->get_symbol ()->get_name ().getString ());
+
+          if (lexical_cast <int> (opArgArguments[1]->unparseToString ()) < 0)
+          {
+            reason = "vector arguments are not supported";
+            return false;
+          }
+        }
+        catch (string const &)
+        {
+          reason = "mapping '" + mapReference->unparseToString ()
+              + "' is not declared";
+          return false;
+        }
+        catch (bad_lexical_cast const &)
+        {
+          reason = "mapping index is not a constant";
+          return false;
+        }
+      }
+    }
+    else if (iequals (opArgName, OP2::OP_ARG_GBL))
+    {
+      /*
+       * ======================================================
+       * Tiles interleave the loops, so a global updated in one
+       * loop cannot be accessed by another
+       * ======================================================
+       */
+
+      string const globalName = opArgArguments.front ()->unparseToString ();
+
+      bool const isRead = opArgArguments.back ()->unparseToString ()
+          == "OP_READ";
+
+      for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+          != chain.end (); ++it)
+      {
+        SgExpressionPtrList const & chainArguments =
+            (*it)->get_args ()->get_expressions ();
+
+        for (unsigned int j = indexFirstOpArg; j < chainArguments.size (); ++j)
+        {
+          SgExpressionPtrList const & chainOpArgArguments = isSgFunctionCallExp (
+              chainArguments[j])->get_args ()->get_expressions ();
+
+          if (iequals (isSgFunctionCallExp (chainArguments[j])->getAssociatedFunctionSymbol ()->get_name ().getString (),
+              OP2::OP_ARG_GBL)
+              && chainOpArgArguments.front ()->unparseToString ()
+                  == globalName && (isRead == false
+              || chainOpArgArguments.back ()->unparseToString () != "OP_READ"))
+          {
+            reason = "global '" + globalName
+                + "' is updated in one loop and accessed in another";
+            return false;
+          }
+        }
+      }
+    }
+    else
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string
+CPPSparseTiling::getParameterName (std::string const & prefix,
+    std::string const & type, SgExpression * expression)
+{
+  using boost::lexical_cast;
+  using std::string;
+
+  string const key = prefix + ":" + expression->unparseToString ();
+
+  if (parameterNames.find (key) == parameterNames.end ())
+  {
+    string const name = prefix + lexical_cast <string> (
+        actualParameters.size ());
+
+    parameterNames[key] = name;
+
+    formalParameters.push_back (type + " " + name);
+
+    actualParameters.push_back (expression);
+  }
+
+  return parameterNames[key];
+}
+
+std::string
+CPPSparseTiling::generateExecutor (std::string const & executorName,
+    std::vector <SgFunctionCallExp *> const & chain)
+{
+  using boost::iequals;
+  using boost::join;
+  using boost::lexical_cast;
+  using std::map;
+  using std::string;
+  using std::vector;
+
+  string const tileSize = lexical_cast <string> (
+      Globals::getInstance ()->getSparseTileSize ());
+
+  string const numberOfLoops = lexical_cast <string> (chain.size ());
+
+  /*
+   * ======================================================
+   * For every loop: the expression giving its number of
+   * elements, the user kernel call made for element 'e' and,
+   * for every OP_DAT argument, the set indexed and the
+   * element accessed
+   * ======================================================
+   */
+
+  vector <string> loopSizes;
+
+  vector <string> kernelCalls;
+
+  vector <vector <string> > accessedSets (chain.size ());
+
+  vector <vector <string> > accessedElements (chain.size ());
+
+  map <string, string> setSizes;
+
+  vector <string> setNames;
+
+  bool updatesGlobals = false;
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    SgExpressionPtrList const & arguments =
+        chain[k]->get_args ()->get_expressions ();
+
+    string const iterationSetName = arguments[indexOpSet]->unparseToString ();
+
+    string const setParameter = getParameterName ("set", "op_set",
+        arguments[indexOpSet]);
+
+    loopSizes.push_back (setParameter + "->size");
+
+    SgFunctionDeclaration * subroutine = getUserSubroutine (chain[k]);
+
+    SgInitializedNamePtrList & formals = subroutine->get_args ();
+
+    vector <string> kernelArguments;
+
+    for (unsigned int i = indexFirstOpArg; i < arguments.size (); ++i)
+    {
+      SgFunctionCallExp * opArgCall = isSgFunctionCallExp (arguments[i]);
+
+      SgExpressionPtrList const & opArgArguments =
+          opArgCall->get_args ()->get_expressions ();
+
+      SgType * formalType = formals[i - indexFirstOpArg]->get_type ();
+
+      if (isSgArrayType (formalType) != NULL)
+      {
+        formalType = SageBuilder::buildPointerType (
+            isSgArrayType (formalType)->get_base_type ());
+      }
+
+      string const castType = formalType->unparseToString ();
+
+      if (iequals (
+          opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+          OP2::OP_ARG_GBL))
+      {
+        kernelArguments.push_back ("(" + castType + ") " + getParameterName (
+            "gbl", "void *", opArgArguments[0]));
+
+        updatesGlobals = updatesGlobals
+            || opArgArguments.back ()->unparseToString () != "OP_READ";
+
+        continue;
+      }
+
+      string const datParameter = getParameterName ("dat", "op_dat",
+          opArgArguments[0]);
+
+      string setName = iterationSetName;
+
+      string element = "e";
+
+      SgVarRefExp * mapReference = isSgVarRefExp (opArgArguments[2]);
+
+      if (mapReference != NULL)
+      {
+        string const mapParameter = getParameterName ("map", "op_map",
+            mapReference);
+
+        setName = declarations->getOpMapDefinition (
+            mapReference->get_symbol ()->get_name ().getString ())->getDestinationOpSetName ();
+
+        element = mapParameter + "->map[" + mapParameter + "->dim * e + "
+            + opArgArguments[1]->unparseToString () + "]";
+
+        if (setSizes.find (setName) == setSizes.end ())
+        {
+          setSizes[setName] = mapParameter + "->to->size";
+          setNames.push_back (setName);
+        }
+      }
+      else if (setSizes.find (setName) == setSizes.end ())
+      {
+        setSizes[setName] = setParameter + "->size";
+        setNames.push_back (setName);
+      }
+
+      accessedSets[k].push_back (setName);
+
+      accessedElements[k].push_back (element);
+
+      kernelArguments.push_back ("((" + castType + ") " + datParameter
+          + "->data) + " + opArgArguments[3]->unparseToString () + " * "
+          + element);
+    }
+
+    kernelCalls.push_back (subroutine->get_name ().getString () + " ("
+        + join (kernelArguments, ", ") + ");");
+  }
+
+  /*
+   * ======================================================
+   * The schedule is kept in statics across invocations and
+   * recomputed whenever the executor is called on other
+   * sets or mappings than those it was computed for
+   * ======================================================
+   */
+
+  vector <string> scheduleKey;
+
+  for (map <string, string>::const_iterator it = parameterNames.begin (); it
+      != parameterNames.end (); ++it)
+  {
+    if (boost::starts_with (it->first, "set:") || boost::starts_with (
+        it->first, "map:"))
+    {
+      scheduleKey.push_back (it->second);
+    }
+  }
+
+  string const keySize = lexical_cast <string> (scheduleKey.size ());
+
+  string code = "/* Sparse tiled executor for "
+      + lexical_cast <string> (chain.size ()) + " loops */\n";
+
+  code += "static void\n" + executorName + " ("
+      + join (formalParameters, ", ") + ")\n{\n";
+
+  code += "  static int numberOfTiles = 0;\n";
+  code += "  static int numberOfColours = 0;\n";
+  code += "  static int parallel;\n";
+  code += "  static int * colourOffsets;\n";
+  code += "  static int * tileOffsets[" + numberOfLoops + "];\n";
+  code += "  static int * tileElements[" + numberOfLoops + "];\n";
+  code += "  static void * scheduleKey[" + keySize + "];\n\n";
+
+  vector <string> keyChanged;
+
+  for (unsigned int i = 0; i < scheduleKey.size (); ++i)
+  {
+    keyChanged.push_back ("scheduleKey[" + lexical_cast <string> (i)
+        + "] != (void *) " + scheduleKey[i]);
+  }
+
+  if (keyChanged.empty () == false)
+  {
+    code += "  if (numberOfTiles != 0 && (" + join (keyChanged, " || ")
+        + "))\n  {\n";
+    code += "    for (int l = 0; l < " + numberOfLoops + "; ++l)\n    {\n";
+    code += "      free (tileOffsets[l]);\n";
+    code += "      free (tileElements[l]);\n    }\n";
+    code += "    free (colourOffsets);\n";
+    code += "    numberOfTiles = 0;\n  }\n\n";
+  }
+
+  /*
+   * ======================================================
+   * Inspector. The blocks seeding the tiles are coloured as
+   * in an OP2 plan, so that blocks sharing an element of any
+   * set get different colours, and the tiles are numbered
+   * colour by colour. 'lastTile_<set>' then holds the latest
+   * tile having touched each element of a set in the loops
+   * inspected so far. Tiles of a loop are computed from the
+   * loops before it only, then the loop's own accesses are
+   * recorded, and the elements of each loop are bucketed by
+   * tile
+   * ======================================================
+   */
+
+  code += "  if (numberOfTiles == 0)\n  {\n";
+  /*
+   * ======================================================
+   * A global updated by one of the loops would be raced on
+   * by tiles run in parallel
+   * ======================================================
+   */
+
+  code += "    parallel = " + string (updatesGlobals ? "0" : "1") + ";\n\n";
+
+  for (unsigned int i = 0; i < scheduleKey.size (); ++i)
+  {
+    code += "    scheduleKey[" + lexical_cast <string> (i) + "] = (void *) "
+        + scheduleKey[i] + ";\n";
+  }
+
+  code += "    numberOfTiles = (" + loopSizes.front () + " + " + tileSize
+      + " - 1) / " + tileSize + ";\n";
+  code += "    if (numberOfTiles == 0)\n      numberOfTiles = 1;\n\n";
+
+  for (vector <string>::const_iterator it = setNames.begin (); it
+      != setNames.end (); ++it)
+  {
+    code += "    int * lastTile_" + *it + " = (int *) calloc ("
+        + setSizes[*it] + ", sizeof (int));\n";
+  }
+
+  code += "\n    {\n";
+  code += "      int * blockColour = (int *) malloc (numberOfTiles * sizeof (int));\n";
+  code += "      int * tileOfBlock = (int *) malloc (numberOfTiles * sizeof (int));\n";
+
+  for (unsigned int i = 0; i < accessedSets.front ().size (); ++i)
+  {
+    string const mask = "colourMask_" + lexical_cast <string> (i);
+
+    code += "      unsigned int * " + mask
+        + " = (unsigned int *) calloc (" + setSizes[accessedSets.front ()[i]]
+        + ", sizeof (unsigned int));\n";
+  }
+
+  code += "\n      numberOfColours = 0;\n";
+  code += "      for (int b = 0; b < numberOfTiles; ++b)\n      {\n";
+  code += "        unsigned int used = 0;\n";
+  code += "        int c = 0;\n";
+  code += "        for (int e = b * " + tileSize + "; e < (b + 1) * " + tileSize
+      + " && e < " + loopSizes.front () + "; ++e)\n        {\n";
+
+  for (unsigned int i = 0; i < accessedSets.front ().size (); ++i)
+  {
+    code += "          used |= colourMask_" + lexical_cast <string> (i) + "["
+        + accessedElements.front ()[i] + "];\n";
+  }
+
+  code += "        }\n";
+  code += "        while (c < 32 && (used & (1u << c)) != 0)\n          ++c;\n";
+  code += "        if (c == 32)\n        {\n";
+  code += "          parallel = 0;\n          c = 0;\n        }\n";
+  code += "        for (int e = b * " + tileSize + "; e < (b + 1) * " + tileSize
+      + " && e < " + loopSizes.front () + "; ++e)\n        {\n";
+
+  for (unsigned int i = 0; i < accessedSets.front ().size (); ++i)
+  {
+    code += "          colourMask_" + lexical_cast <string> (i) + "["
+        + accessedElements.front ()[i] + "] |= 1u << c;\n";
+  }
+
+  code += "        }\n";
+  code += "        blockColour[b] = c;\n";
+  code += "        if (c + 1 > numberOfColours)\n";
+  code += "          numberOfColours = c + 1;\n      }\n\n";
+
+  code += "      colourOffsets = (int *) calloc (numberOfColours + 1, sizeof (int));\n";
+  code += "      for (int b = 0; b < numberOfTiles; ++b)\n";
+  code += "        colourOffsets[blockColour[b] + 1]++;\n";
+  code += "      for (int c = 0; c < numberOfColours; ++c)\n";
+  code += "        colourOffsets[c + 1] += colourOffsets[c];\n";
+  code += "      for (int b = 0; b < numberOfTiles; ++b)\n";
+  code += "        tileOfBlock[b] = colourOffsets[blockColour[b]]++;\n";
+  code += "      for (int c = numberOfColours; c > 0; --c)\n";
+  code += "        colourOffsets[c] = colourOffsets[c - 1];\n";
+  code += "      colourOffsets[0] = 0;\n\n";
+
+  for (unsigned int i = 0; i < accessedSets.front ().size (); ++i)
+  {
+    code += "      free (colourMask_" + lexical_cast <string> (i) + ");\n";
+  }
+
+  code += "      free (blockColour);\n";
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    string const loop = lexical_cast <string> (k);
+
+    code += "\n      {\n";
+    code += "        int * tile = (int *) malloc (" + loopSizes[k]
+        + " * sizeof (int));\n\n";
+
+    code += "        for (int e = 0; e < " + loopSizes[k] + "; ++e)\n        {\n";
+
+    if (k == 0)
+    {
+      code += "          int t = tileOfBlock[e / " + tileSize + "];\n";
+    }
+    else
+    {
+      code += "          int t = 0;\n";
+
+      for (unsigned int i = 0; i < accessedSets[k].size (); ++i)
+      {
+        string const last = "lastTile_" + accessedSets[k][i] + "["
+            + accessedElements[k][i] + "]";
+
+        code += "          if (" + last + " > t)\n            t = " + last
+            + ";\n";
+      }
+    }
+
+    code += "          tile[e] = t;\n        }\n\n";
+
+    code += "        for (int e = 0; e < " + loopSizes[k] + "; ++e)\n        {\n";
+
+    for (unsigned int i = 0; i < accessedSets[k].size (); ++i)
+    {
+      string const last = "lastTile_" + accessedSets[k][i] + "["
+          + accessedElements[k][i] + "]";
+
+      code += "          if (" + last + " < tile[e])\n            " + last
+          + " = tile[e];\n";
+    }
+
+    code += "        }\n\n";
+
+    code += "        tileOffsets[" + loop
+        + "] = (int *) calloc (numberOfTiles + 1, sizeof (int));\n";
+    code += "        tileElements[" + loop + "] = (int *) malloc ("
+        + loopSizes[k] + " * sizeof (int));\n";
+    code += "        for (int e = 0; e < " + loopSizes[k] + "; ++e)\n";
+    code += "          tileOffsets[" + loop + "][tile[e] + 1]++;\n";
+    code += "        for (int t = 0; t < numberOfTiles; ++t)\n";
+    code += "          tileOffsets[" + loop + "][t + 1] += tileOffsets["
+        + loop + "][t];\n";
+    code += "        for (int e = 0; e < " + loopSizes[k] + "; ++e)\n";
+    code += "          tileElements[" + loop + "][tileOffsets[" + loop
+        + "][tile[e]]++] = e;\n";
+    code += "        for (int t = numberOfTiles; t > 0; --t)\n";
+    code += "          tileOffsets[" + loop + "][t] = tileOffsets[" + loop
+        + "][t - 1];\n";
+    code += "        tileOffsets[" + loop + "][0] = 0;\n\n";
+    code += "        free (tile);\n      }\n";
+  }
+
+  code += "\n      free (tileOfBlock);\n    }\n\n";
+
+  /*
+   * ======================================================
+   * Growing the tiles may make two tiles of one colour touch
+   * the same element. This is checked colour by colour,
+   * reusing 'lastTile_<set>' to hold the tile of the colour
+   * touching each element; on a clash, or when the seed
+   * blocks needed more than 32 colours, the tiles are run
+   * one after the other
+   * ======================================================
+   */
+
+  code += "    for (int c = 0; c < numberOfColours && parallel; ++c)\n    {\n";
+
+  for (vector <string>::const_iterator it = setNames.begin (); it
+      != setNames.end (); ++it)
+  {
+    code += "      for (int x = 0; x < " + setSizes[*it] + "; ++x)\n";
+    code += "        lastTile_" + *it + "[x] = -1;\n";
+  }
+
+  code += "      for (int t = colourOffsets[c]; t < colourOffsets[c + 1]; ++t)\n      {\n";
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    string const loop = lexical_cast <string> (k);
+
+    code += "        for (int n = tileOffsets[" + loop + "][t]; n < tileOffsets["
+        + loop + "][t + 1]; ++n)\n        {\n";
+    code += "          int e = tileElements[" + loop + "][n];\n";
+
+    for (unsigned int i = 0; i < accessedSets[k].size (); ++i)
+    {
+      string const last = "lastTile_" + accessedSets[k][i] + "["
+          + accessedElements[k][i] + "]";
+
+      code += "          if (" + last + " != -1 && " + last + " != t)\n";
+      code += "            parallel = 0;\n";
+      code += "          " + last + " = t;\n";
+    }
+
+    code += "        }\n";
+  }
+
+  code += "      }\n    }\n\n";
+
+  code += "    if (parallel == 0)\n    {\n";
+  code += "      numberOfColours = 1;\n";
+  code += "      colourOffsets[1] = numberOfTiles;\n    }\n\n";
+
+  for (vector <string>::const_iterator it = setNames.begin (); it
+      != setNames.end (); ++it)
+  {
+    code += "    free (lastTile_" + *it + ");\n";
+  }
+
+  code += "  }\n\n";
+
+  /*
+   * ======================================================
+   * Executor: colours are run in order and the tiles of a
+   * colour in parallel, unless the inspector fell back to
+   * running the tiles one after the other; within a tile
+   * the slice of every loop is run before the slice of the
+   * next loop
+   * ======================================================
+   */
+
+  code += "  for (int c = 0; c < numberOfColours; ++c)\n  {\n";
+  code += "#pragma omp parallel for if (parallel)\n";
+  code += "    for (int t = colourOffsets[c]; t < colourOffsets[c + 1]; ++t)\n    {\n";
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    string const loop = lexical_cast <string> (k);
+
+    code += "      for (int n = tileOffsets[" + loop + "][t]; n < tileOffsets["
+        + loop + "][t + 1]; ++n)\n      {\n";
+    code += "        int e = tileElements[" + loop + "][n];\n";
+    code += "        " + kernelCalls[k] + "\n      }\n";
+  }
+
+  code += "    }\n  }\n}\n";
+
+  return code;
+}
+
+void
+CPPSparseTiling::tileChain (std::vector <SgFunctionCallExp *> const & chain,
+    std::vector <SgStatement *> const & hoisted)
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using boost::lexical_cast;
+  using std::string;
+  using std::vector;
+
+  string executorName;
+
+  string chainDescription;
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    string const kernelName = getUserSubroutine (*it)->get_name ().getString ();
+
+    executorName += kernelName + "__";
+
+    chainDescription += (it == chain.begin () ? "" : " -> ") + kernelName;
+  }
+
+  executorName += "tiled" + lexical_cast <string> (numberOfExecutors++);
+
+  Debug::getInstance ()->debugMessage ("Generating sparse tiled executor '"
+      + executorName + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  parameterNames.clear ();
+
+  formalParameters.clear ();
+
+  actualParameters.clear ();
+
+  string const executor = generateExecutor (executorName, chain);
+
+  SgStatement * firstStatement = isSgStatement (chain.front ()->get_parent ());
+
+  SgScopeStatement * scope = getScope (firstStatement);
+
+  /*
+   * ======================================================
+   * The executor is emitted in front of the function
+   * containing the chain, where the OP2 types and the user
+   * kernels are visible
+   * ======================================================
+   */
+
+  SgFunctionDeclaration * enclosingFunction = getEnclosingFunctionDeclaration (
+      firstStatement);
+
+  ROSE_ASSERT (enclosingFunction != NULL);
+
+  addTextForUnparser (enclosingFunction, executor, AstUnparseAttribute::e_before);
+
+  for (vector <SgStatement *>::const_iterator it = hoisted.begin (); it
+      != hoisted.end (); ++it)
+  {
+    removeStatement (*it);
+
+    insertStatementBefore (firstStatement, *it);
+  }
+
+  SgExprListExp * actuals = buildExprListExp ();
+
+  for (vector <SgExpression *>::const_iterator it = actualParameters.begin (); it
+      != actualParameters.end (); ++it)
+  {
+    actuals->append_expression (deepCopy (*it));
+  }
+
+  SgExprStatement * executorCall = buildExprStatement (buildFunctionCallExp (
+      executorName, buildVoidType (), actuals, scope));
+
+  insertStatementBefore (firstStatement, executorCall);
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    removeStatement (isSgStatement ((*it)->get_parent ()));
+  }
+
+  std::cout << "Tiled '" << chainDescription << "' into '" << executorName
+      << "': " << chain.size () << " loops, tiles of "
+      << Globals::getInstance ()->getSparseTileSize () << " elements of '"
+      << chain.front ()->get_args ()->get_expressions ()[indexOpSet]->unparseToString ()
+      << "'" << std::endl;
+}
+
+void
+CPPSparseTiling::tileBasicBlock (SgBasicBlock * basicBlock)
+{
+  using std::string;
+  using std::vector;
+
+  /*
+   * ======================================================
+   * Chains are grown greedily through the statements of the
+   * block; a chain is tiled when it holds at least two loops
+   * of which one is indirect, as direct chains on one set
+   * are better served by fusion
+   * ======================================================
+   */
+
+  SgStatementPtrList const statements = basicBlock->get_statements ();
+
+  vector <SgFunctionCallExp *> chain;
+
+  vector <SgStatement *> hoisted;
+
+  for (unsigned int i = 0; i <= statements.size (); ++i)
+  {
+    SgFunctionCallExp * parallelLoopCall = i < statements.size ()
+        ? getParallelLoopCall (statements[i]) : NULL;
+
+    string reason;
+
+    if (parallelLoopCall != NULL && chain.empty () == false)
+    {
+      if (isTilingLegal (chain, parallelLoopCall, reason))
+      {
+        chain.push_back (parallelLoopCall);
+
+        continue;
+      }
+
+      std::cout << "Not tiling '"
+          << getUserSubroutine (chain.front ())->get_name ().getString ()
+          << "' chain across "
+          << parallelLoopCall->get_args ()->get_expressions ()[1]->unparseToString ()
+          << ": " << reason << std::endl;
+    }
+    else if (parallelLoopCall == NULL && i < statements.size ()
+        && chain.empty () == false && isHoistable (statements[i], chain))
+    {
+      hoisted.push_back (statements[i]);
+
+      continue;
+    }
+
+    bool indirect = false;
+
+    for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+        != chain.end (); ++it)
+    {
+      indirect = indirect || isIndirect (*it);
+    }
+
+    if (chain.size () > 1 && indirect)
+    {
+      tileChain (chain, hoisted);
+    }
+
+    chain.clear ();
+
+    hoisted.clear ();
+
+    if (parallelLoopCall != NULL && isTilingLegal (chain, parallelLoopCall,
+        reason))
+    {
+      chain.push_back (parallelLoopCall);
+    }
+  }
+}
+
+CPPSparseTiling::CPPSparseTiling (SgProject * project,
+    CPPProgramDeclarationsAndDefinitions * declarations) :
+  project (project), declarations (declarations), numberOfExecutors (0)
+{
+  using std::vector;
+
+  Debug::getInstance ()->debugMessage (
+      "Sparse tiling chains of OP_PAR_LOOPs", Debug::CONSTRUCTOR_LEVEL,
+      __FILE__, __LINE__);
+
+  traverseInputFiles (project, preorder);
+
+  for (vector <SgBasicBlock *>::const_iterator it = basicBlocks.begin (); it
+      != basicBlocks.end (); ++it)
+  {
+    tileBasicBlock (*it);
+  }
+}
@@ -0,0 +1,160 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+#ifndef CPP_SPARSE_TILING_H
+#define CPP_SPARSE_TILING_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <rose.h>
+#include "OP2Definitions.h"
+
+class CPPProgramDeclarationsAndDefinitions;
+
+/*
+ * ======================================================
+ * Sparse tiling of chains of OP_PAR_LOOPs connected
+ * through mappings. Each chain is replaced by a call to a
+ * generated executor which, on its first invocation, runs
+ * an inspector assigning every element of every loop to a
+ * tile: the first loop is cut into blocks of consecutive
+ * elements and each later element joins the latest tile
+ * that touched, in an earlier loop, any of the set
+ * elements it accesses. Running the tiles in order, and
+ * the slice of each loop within a tile, then respects all
+ * dependences between the loops while the data touched by
+ * a tile stays in cache. The seed blocks are coloured so
+ * that tiles of one colour touch disjoint elements and run
+ * in parallel under OpenMP. The executor calls the user
+ * kernels on the host copy of the OP_DATs, bypassing
+ * OP_PAR_LOOP, so tiled programs must be built with the
+ * sequential or OpenMP OP2 libraries
+ * ======================================================
+ */
+
+class CPPSparseTiling: public AstSimpleProcessing
+{
+  private:
+
+    /*
+     * ======================================================
+     * In an OP_PAR_LOOP call the user kernel appears in
+     * position 0, its name in position 1, the iteration set
+     * in position 2 and the OP_ARG calls from position 3
+     * ======================================================
+     */
+    static unsigned int const indexOpSet = 2;
+
+    static unsigned int const indexFirstOpArg = 3;
+
+    SgProject * project;
+
+    CPPProgramDeclarationsAndDefinitions * declarations;
+
+    /*
+     * ======================================================
+     * Basic blocks in which chains of OP_PAR_LOOP calls are
+     * looked for
+     * ======================================================
+     */
+    std::vector <SgBasicBlock *> basicBlocks;
+
+    /*
+     * ======================================================
+     * Number of executors generated so far. Every tiled chain
+     * gets its own executor, so that the schedule computed by
+     * its inspector can be kept across invocations made on
+     * the same sets and mappings
+     * ======================================================
+     */
+    unsigned int numberOfExecutors;
+
+    /*
+     * ======================================================
+     * While an executor is generated: the name of the formal
+     * parameter standing for each OP_SET, OP_DAT, OP_MAP and
+     * global accessed by the chain, the formal parameters
+     * and the actual arguments of the replacing call
+     * ======================================================
+     */
+    std::map <std::string, std::string> parameterNames;
+
+    std::vector <std::string> formalParameters;
+
+    std::vector <SgExpression *> actualParameters;
+
+  private:
+
+    virtual void
+    visit (SgNode * node);
+
+    SgFunctionCallExp *
+    getParallelLoopCall (SgStatement * statement);
+
+    SgFunctionDeclaration *
+    getUserSubroutine (SgFunctionCallExp * parallelLoopCall);
+
+    bool
+    isIndirect (SgFunctionCallExp * parallelLoopCall);
+
+    bool
+    isHoistable (SgStatement * statement,
+        std::vector <SgFunctionCallExp *> const & chain);
+
+    bool
+    isTilingLegal (std::vector <SgFunctionCallExp *> const & chain,
+        SgFunctionCallExp * candidate, std::string & reason);
+
+    std::string
+    getParameterName (std::string const & prefix, std::string const & type,
+        SgExpression * expression);
+
+    std::string
+    generateExecutor (std::string const & executorName,
+        std::vector <SgFunctionCallExp *> const & chain);
+
+    void
+    tileChain (std::vector <SgFunctionCallExp *> const & chain,
+        std::vector <SgStatement *> const & hoisted);
+
+    void
+    tileBasicBlock (SgBasicBlock * basicBlock);
+
+  public:
+
+    CPPSparseTiling (SgProject * project,
+        CPPProgramDeclarationsAndDefinitions * declarations);
+};
+
+#endif
@@ -30,6 +30,7 @@
  */
 
 
+#include <boost/lexical_cast.hpp>
 #include "CPPSubroutinesGeneration.h"
 #include "CPPParallelLoop.h"
 #include "CPPHostSubroutine.h"
@@ -46,6 +47,141 @@ CPPSubroutinesGeneration::addFreeVariableDeclarations ()
 {
 }
 
+CPPUserSubroutine *
+CPPSubroutinesGeneration::shareUserSubroutine (
+    CPPUserSubroutine * userSubroutine)
+{
+  using namespace SageInterface;
+  using std::map;
+  using std::string;
+
+  SgFunctionDeclaration * subroutineHeader =
+      userSubroutine->getSubroutineHeaderStatement ();
+
+  SgInitializedNamePtrList & formalParameters =
+      subroutineHeader->get_parameterList ()->get_args ();
+
+  string key;
+
+  for (SgInitializedNamePtrList::iterator it = formalParameters.begin (); it
+      != formalParameters.end (); ++it)
+  {
+    key += (*it)->get_storageModifier ().displayString () + " "
+        + (*it)->get_type ()->unparseToString () + " "
+        + (*it)->get_name ().getString () + ";";
+  }
+
+  key += subroutineHeader->get_definition ()->get_body ()->unparseToString ();
+
+  map <string, CPPUserSubroutine *>::const_iterator it =
+      emittedUserSubroutines.find (key);
+
+  if (it == emittedUserSubroutines.end ())
+  {
+    emittedUserSubroutines[key] = userSubroutine;
+
+    addBuiltSubroutine (subroutineHeader);
+
+    return userSubroutine;
+  }
+
+  Debug::getInstance ()->debugMessage ("User subroutine '"
+      + userSubroutine->getSubroutineName () + "' is identical to '"
+      + it->second->getSubroutineName () + "', which is shared",
+      Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  return it->second;
+}
+
+void
+CPPSubroutinesGeneration::addBuiltSubroutine (
+    SgFunctionDeclaration * subroutine)
+{
+  builtSubroutines.push_back (subroutine);
+}
+
+void
+CPPSubroutinesGeneration::insertSubroutines ()
+{
+  using namespace SageInterface;
+  using std::vector;
+
+  Debug::getInstance ()->debugMessage ("Inserting "
+      + boost::lexical_cast <std::string> (builtSubroutines.size ())
+      + " generated subroutines", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  for (vector <SgFunctionDeclaration *>::const_iterator it =
+      builtSubroutines.begin (); it != builtSubroutines.end (); ++it)
+  {
+    appendStatement (*it, moduleScope);
+  }
+
+  builtSubroutines.clear ();
+}
+
+void
+CPPSubroutinesGeneration::checkPrecisionPolicy ()
+{
+  using std::map;
+  using std::string;
+
+  for (map <string, ParallelLoop *>::const_iterator it =
+      declarations->firstParallelLoop (); it
+      != declarations->lastParallelLoop (); ++it)
+  {
+    string const & userSubroutineName = it->first;
+
+    ParallelLoop * parallelLoop = it->second;
+
+    for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+    {
+      if (parallelLoop->isMixedPrecision (i) == false)
+      {
+        continue;
+      }
+
+      string const & opDatName = parallelLoop->getOpDatVariableName (i);
+
+      if (Globals::getInstance ()->getTargetBackend () != TargetLanguage::CUDA
+          || parallelLoop->isDirectLoop () == false)
+      {
+        throw Exceptions::ParallelLoop::UnsupportedBaseTypeException (
+            "The precision policy names OP_DAT '" + opDatName
+                + "', passed to OP_PAR_LOOP '" + userSubroutineName
+                + "', but mixed precision is only supported in CUDA direct loops");
+      }
+
+      SgType * parameterType =
+          declarations->getUserKernelFormalParameterType (i,
+              userSubroutineName)->stripTypedefsAndModifiers ();
+
+      SgType * receivedType = NULL;
+
+      if (isSgPointerType (parameterType))
+      {
+        receivedType
+            = isSgPointerType (parameterType)->get_base_type ()->stripTypedefsAndModifiers ();
+      }
+      else if (isSgArrayType (parameterType))
+      {
+        receivedType
+            = isSgArrayType (parameterType)->get_base_type ()->stripTypedefsAndModifiers ();
+      }
+
+      if (receivedType == NULL || receivedType->variantT ()
+          != parallelLoop->getOpDatComputeType (i)->variantT ())
+      {
+        throw Exceptions::ParallelLoop::UnsupportedBaseTypeException (
+            "User kernel '" + userSubroutineName + "' receives OP_DAT '"
+                + opDatName + "' as '" + parameterType->unparseToString ()
+                + "' but the precision policy computes on it in '"
+                + parallelLoop->getOpDatComputeType (i)->unparseToString ()
+                + "'");
+      }
+    }
+  }
+}
+
 void
 CPPSubroutinesGeneration::addOP2IncludeDirective ()
 {
@@ -87,7 +223,17 @@ CPPSubroutinesGeneration::patchCallsToParallelLoops ()
   Debug::getInstance ()->debugMessage ("Patching calls to OP_PAR_LOOPs",
       Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
-  vector <string> processedFiles;
+  /*
+   * ======================================================
+   * Prototypes of the host subroutines are built per loop
+   * and only inserted once every loop has been handled,
+   * file by file, so each file is searched for its last
+   * declaration once and each host subroutine is declared
+   * once per file however often it is called there
+   * ======================================================
+   */
+
+  map <string, vector <SgFunctionDeclaration *> > prototypes;
 
   for (map <string, ParallelLoop *>::const_iterator it =
       declarations->firstParallelLoop (); it
@@ -110,9 +256,6 @@ CPPSubroutinesGeneration::patchCallsToParallelLoops ()
     {
       SgFunctionCallExp * functionCallExpression = *it;
 
-      SgScopeStatement * scope = isSgExprStatement (
-          functionCallExpression->get_parent ())->get_scope ();
-
       SgFunctionRefExp * hostSubroutineReference = buildFunctionRefExp (
           hostSubroutine->getSubroutineHeaderStatement ());
 
@@ -133,30 +276,36 @@ CPPSubroutinesGeneration::patchCallsToParallelLoops ()
 
       arguments.insert (arguments.begin (), buildStringVal (
           userSubroutines[userSubroutineName]->getSubroutineName ()));
+    }
 
-      for (vector <string>::const_iterator it =
-          parallelLoop->getFirstFileName (); it
-          != parallelLoop->getLastFileName (); ++it)
-      {
-        string fileName = *it;
-
-        Debug::getInstance ()->debugMessage ("Analysing file '" + fileName
-            + "'", Debug::INNER_LOOP_LEVEL, __FILE__, __LINE__);
+    for (vector <string>::const_iterator it =
+        parallelLoop->getFirstFileName (); it
+        != parallelLoop->getLastFileName (); ++it)
+    {
+      string const & fileName = *it;
 
-        SgSourceFile * sourceFile = declarations->getSourceFile (fileName);
+      Debug::getInstance ()->debugMessage ("Analysing file '" + fileName
+          + "'", Debug::INNER_LOOP_LEVEL, __FILE__, __LINE__);
 
-        SgScopeStatement * fileScope = sourceFile->get_globalScope ();
+      SgSourceFile * sourceFile = declarations->getSourceFile (fileName);
 
-        SgFunctionDeclaration * nonDefininingDeclaration =
-            buildNondefiningFunctionDeclaration (
-                hostSubroutine->getSubroutineName (), buildVoidType (),
-                hostSubroutine->getCopyOfFormalParameters (), fileScope);
+      prototypes[fileName].push_back (buildNondefiningFunctionDeclaration (
+          hostSubroutine->getSubroutineName (), buildVoidType (),
+          hostSubroutine->getCopyOfFormalParameters (),
+          sourceFile->get_globalScope ()));
+    }
+  }
 
-        SgStatement * declarationStatement = findLastDeclarationStatement (
-            fileScope);
+  for (map <string, vector <SgFunctionDeclaration *> >::const_iterator it =
+      prototypes.begin (); it != prototypes.end (); ++it)
+  {
+    SgStatement * declarationStatement = findLastDeclarationStatement (
+        declarations->getSourceFile (it->first)->get_globalScope ());
 
-        insertStatementBefore (declarationStatement, nonDefininingDeclaration);
-      }
+    for (vector <SgFunctionDeclaration *>::const_iterator prototype =
+        it->second.begin (); prototype != it->second.end (); ++prototype)
+    {
+      insertStatementBefore (declarationStatement, *prototype);
     }
   }
 }
@@ -166,6 +315,8 @@ CPPSubroutinesGeneration::generate ()
 {
   moduleScope = sourceFile->get_globalScope ();
 
+  checkPrecisionPolicy ();
+
   addHeaderIncludes ();
 
   addFreeVariableDeclarations ();
@@ -174,6 +325,8 @@ CPPSubroutinesGeneration::generate ()
 
   createSubroutines ();
 
+  insertSubroutines ();
+
   patchCallsToParallelLoops ();
 
   addOP2IncludeDirective ();
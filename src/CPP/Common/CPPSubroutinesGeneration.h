@@ -53,8 +53,64 @@ class CPPSubroutinesGeneration: public SubroutinesGeneration <
 
     std::map <std::string, CPPUserSubroutine *> userSubroutines;
 
+    /*
+     * ======================================================
+     * The user subroutines emitted so far, keyed by their
+     * unparsed formal parameters and body
+     * ======================================================
+     */
+    std::map <std::string, CPPUserSubroutine *> emittedUserSubroutines;
+
+    /*
+     * ======================================================
+     * The subroutines built for the parallel loops, detached
+     * from the module scope, in the order in which they are
+     * inserted into it once every loop has been built
+     * ======================================================
+     */
+    std::vector <SgFunctionDeclaration *> builtSubroutines;
+
   protected:
 
+    /*
+     * ======================================================
+     * Returns an already emitted user subroutine identical to
+     * the given one, whose declaration is then never inserted
+     * into the generated file, or the given one if it is new
+     * ======================================================
+     */
+    CPPUserSubroutine *
+    shareUserSubroutine (CPPUserSubroutine * userSubroutine);
+
+    /*
+     * ======================================================
+     * Records a subroutine built for a parallel loop, to be
+     * inserted into the module scope by insertSubroutines
+     * ======================================================
+     */
+    void
+    addBuiltSubroutine (SgFunctionDeclaration * subroutine);
+
+    /*
+     * ======================================================
+     * Inserts the subroutines built for the parallel loops
+     * into the module scope, in the order they were built
+     * ======================================================
+     */
+    void
+    insertSubroutines ();
+
+    /*
+     * ======================================================
+     * Checks that every OP_DAT named in the precision policy
+     * is passed to a loop whose staging code converts between
+     * storage and compute precision, and that the user kernel
+     * receives it in the compute precision
+     * ======================================================
+     */
+    void
+    checkPrecisionPolicy ();
+
     virtual void
     addFreeVariableDeclarations ();
 
@@ -30,158 +30,1360 @@
  */
 
 #include <boost/lexical_cast.hpp>
-#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include "CPPSyntacticFusion.h"
 #include "CPPProgramDeclarationsAndDefinitions.h"
 #include "CPPOP2Definitions.h"
+#include "CallSiteOpDats.h"
 #include "Debug.h"
 #include "Exceptions.h"
 #include "OP2.h"
 
 #include "Globals.h"
 
+#include <algorithm>
+#include <iostream>
+
 void
-CPPSyntacticFusion::visit (SgNode* node)
+CPPSyntacticFusion::visit (SgNode * node)
+{
+  SgBasicBlock * basicBlock = isSgBasicBlock (node);
+
+  if (basicBlock != NULL)
+  {
+    basicBlocks.push_back (basicBlock);
+  }
+}
+
+SgFunctionCallExp *
+CPPSyntacticFusion::getParallelLoopCall (SgStatement * statement)
 {
+  using boost::iequals;
+
+  SgExprStatement * expressionStatement = isSgExprStatement (statement);
+
+  if (expressionStatement == NULL)
+  {
+    return NULL;
+  }
+
+  SgFunctionCallExp * functionCallExp = isSgFunctionCallExp (
+      expressionStatement->get_expression ());
+
+  if (functionCallExp == NULL
+      || functionCallExp->getAssociatedFunctionSymbol () == NULL
+      || iequals (
+          functionCallExp->getAssociatedFunctionSymbol ()->get_name ().getString (),
+          OP2::OP_PAR_LOOP) == false)
+  {
+    return NULL;
+  }
+
+  return functionCallExp;
+}
+
+std::string
+CPPSyntacticFusion::getUserSubroutineName (SgFunctionCallExp * parallelLoopCall)
+{
+  SgFunctionRefExp * functionRefExpression = isSgFunctionRefExp (
+      parallelLoopCall->get_args ()->get_expressions ().front ());
+
+  ROSE_ASSERT (functionRefExpression != NULL);
+
+  return functionRefExpression->getAssociatedFunctionDeclaration ()->get_name ().getString ();
+}
+
+bool
+CPPSyntacticFusion::isFusionLegal (
+    std::vector <SgFunctionCallExp *> const & chain,
+    SgFunctionCallExp * candidate, std::string & reason)
+{
+  using std::map;
+  using std::string;
+  using std::vector;
+
+  /*
+   * ======================================================
+   * Loops can only be fused when they iterate over the same
+   * set and every OP_ARG is given through an OP_ARG call
+   * (Oxford API), so that arguments can be moved between
+   * calls
+   * ======================================================
+   */
+
+  SgExpressionPtrList const & candidateArguments =
+      candidate->get_args ()->get_expressions ();
+
+  if (candidateArguments[indexOpSet]->unparseToString ()
+      != chain.front ()->get_args ()->get_expressions ()[indexOpSet]->unparseToString ())
+  {
+    reason = "different iteration sets";
+    return false;
+  }
+
+  SgExpressionPtrList const & firstArguments =
+      chain.front ()->get_args ()->get_expressions ();
+
+  for (unsigned int i = indexFirstOpArg; i < candidateArguments.size (); ++i)
+  {
+    if (isSgFunctionCallExp (candidateArguments[i]) == NULL)
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+  }
+
+  for (unsigned int i = indexFirstOpArg; i < firstArguments.size (); ++i)
+  {
+    if (isSgFunctionCallExp (firstArguments[i]) == NULL)
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+  }
+
+  /*
+   * ======================================================
+   * Every element is then visited once by the fused loop,
+   * which runs the kernels one after the other. This is
+   * only equivalent to running the loops in sequence if
+   * data written by one loop and accessed by another is
+   * accessed directly by both, i.e. dependences only exist
+   * on the same element, and no global is reduced in one
+   * loop and accessed in another
+   * ======================================================
+   */
+
+  ParallelLoop * candidateLoop = declarations->getParallelLoop (
+      getUserSubroutineName (candidate));
+
+  /*
+   * ======================================================
+   * The OP_DATs are taken from each call, as a kernel called
+   * at several sites may be passed other OP_DATs than at its
+   * first call site
+   * ======================================================
+   */
+
+  map <unsigned int, string> candidateOpDats = getCallSiteOpDatNames (
+      declarations, candidate, candidateLoop);
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    ParallelLoop * parallelLoop = declarations->getParallelLoop (
+        getUserSubroutineName (*it));
+
+    map <unsigned int, string> opDats = getCallSiteOpDatNames (declarations,
+        *it, parallelLoop);
+
+    for (unsigned int i = 1; i
+        <= candidateLoop->getNumberOfOpDatArgumentGroups (); ++i)
+    {
+      for (unsigned int j = 1; j
+          <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++j)
+      {
+        string const variableName = candidateLoop->isGlobal (i)
+            ? candidateLoop->getOpDatVariableName (i) : candidateOpDats[i];
+
+        string const otherVariableName = parallelLoop->isGlobal (j)
+            ? parallelLoop->getOpDatVariableName (j) : opDats[j];
+
+        if (variableName != otherVariableName
+            || (candidateLoop->isRead (i) && parallelLoop->isRead (j)))
+        {
+          continue;
+        }
+
+        if (candidateLoop->isGlobal (i) || parallelLoop->isGlobal (j))
+        {
+          reason = "global '" + variableName
+              + "' is updated in one loop and accessed in the other";
+          return false;
+        }
+
+        if (candidateLoop->isDirect (i) == false || parallelLoop->isDirect (
+            j) == false)
+        {
+          reason = "'" + variableName
+              + "' is updated in one loop and accessed through a mapping";
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+SgVariableDeclaration *
+CPPSyntacticFusion::getMapDeclaration (SgVarRefExp * mapReference)
+{
+  SgInitializedName * variable =
+      mapReference->get_symbol ()->get_declaration ();
+
+  return isSgVariableDeclaration (variable->get_declaration ());
+}
+
+bool
+CPPSyntacticFusion::isProducerConsumerFusionLegal (
+    SgFunctionCallExp * producer, SgFunctionCallExp * consumer,
+    SgVarRefExp * & mapReference, std::string & reason)
+{
+  using boost::iequals;
+  using boost::lexical_cast;
+  using boost::bad_lexical_cast;
+  using std::find;
+  using std::string;
+  using std::vector;
+
+  /*
+   * ======================================================
+   * A loop over one set (the producer) can be folded into
+   * the following loop over another set (the consumer) when
+   * the consumer reads what the producer writes through a
+   * single mapping from the consumer set to the producer
+   * set. The producer is then recomputed, for each element
+   * of the consumer, on every element reached through that
+   * mapping. This is only equivalent when recomputing is
+   * idempotent: the producer only reads or writes (never
+   * increments) its data, never reads what it writes, and
+   * the consumer does not update what the producer reads
+   * ======================================================
+   */
+
+  SgExpressionPtrList const & producerArguments =
+      producer->get_args ()->get_expressions ();
+
+  SgExpressionPtrList const & consumerArguments =
+      consumer->get_args ()->get_expressions ();
+
+  for (unsigned int i = indexFirstOpArg; i < producerArguments.size (); ++i)
+  {
+    if (isSgFunctionCallExp (producerArguments[i]) == NULL)
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+  }
+
+  for (unsigned int i = indexFirstOpArg; i < consumerArguments.size (); ++i)
+  {
+    if (isSgFunctionCallExp (consumerArguments[i]) == NULL)
+    {
+      reason = "arguments not given through OP_ARG calls";
+      return false;
+    }
+  }
+
+  vector <string> written;
+
+  vector <string> read;
+
+  vector <string> globals;
+
+  vector <SgVarRefExp *> producerMaps;
+
+  for (unsigned int i = indexFirstOpArg; i < producerArguments.size (); ++i)
+  {
+    SgFunctionCallExp * opArgCall = isSgFunctionCallExp (producerArguments[i]);
+
+    SgExpressionPtrList const & opArgArguments =
+        opArgCall->get_args ()->get_expressions ();
+
+    string const variableName = opArgArguments.front ()->unparseToString ();
+
+    string const access = opArgArguments.back ()->unparseToString ();
+
+    if (iequals (
+        opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+        OP2::OP_ARG_GBL))
+    {
+      if (access != "OP_READ")
+      {
+        reason = "the producer updates global '" + variableName + "'";
+        return false;
+      }
+
+      globals.push_back (variableName);
+
+      continue;
+    }
+
+    SgVarRefExp * producerMap = isSgVarRefExp (opArgArguments[2]);
+
+    if (producerMap != NULL)
+    {
+      if (access != "OP_READ")
+      {
+        reason = "the producer updates '" + variableName
+            + "' through a mapping";
+        return false;
+      }
+
+      try
+      {
+        declarations->getOpMapDefinition (
+            producerMap->get_symbol ()->get_name ().getString ());
+
+        if (lexical_cast <int> (opArgArguments[1]->unparseToString ()) < 0)
+        {
+          reason = "the producer has vector arguments";
+          return false;
+        }
+      }
+      catch (string const &)
+      {
+        reason = "mapping '" + producerMap->unparseToString ()
+            + "' is not declared";
+        return false;
+      }
+      catch (bad_lexical_cast const &)
+      {
+        reason = "mapping index is not a constant";
+        return false;
+      }
+
+      producerMaps.push_back (producerMap);
+
+      read.push_back (variableName);
+    }
+    else if (access == "OP_WRITE")
+    {
+      written.push_back (variableName);
+    }
+    else if (access == "OP_READ")
+    {
+      read.push_back (variableName);
+    }
+    else
+    {
+      reason = "the producer increments or reads and writes '"
+          + variableName + "'";
+      return false;
+    }
+  }
+
+  for (vector <string>::const_iterator it = written.begin (); it
+      != written.end (); ++it)
+  {
+    if (find (read.begin (), read.end (), *it) != read.end ())
+    {
+      reason = "the producer reads '" + *it + "', which it writes";
+      return false;
+    }
+  }
+
+  mapReference = NULL;
+
+  for (unsigned int i = indexFirstOpArg; i < consumerArguments.size (); ++i)
+  {
+    SgFunctionCallExp * opArgCall = isSgFunctionCallExp (consumerArguments[i]);
+
+    SgExpressionPtrList const & opArgArguments =
+        opArgCall->get_args ()->get_expressions ();
+
+    string const variableName = opArgArguments.front ()->unparseToString ();
+
+    string const access = opArgArguments.back ()->unparseToString ();
+
+    if (iequals (
+        opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+        OP2::OP_ARG_GBL))
+    {
+      if (access != "OP_READ" && find (globals.begin (), globals.end (),
+          variableName) != globals.end ())
+      {
+        reason = "the consumer updates global '" + variableName
+            + "', which the producer reads";
+        return false;
+      }
+
+      continue;
+    }
+
+    if (find (written.begin (), written.end (), variableName) != written.end ())
+    {
+      SgVarRefExp * consumerMap = isSgVarRefExp (opArgArguments[2]);
+
+      if (consumerMap == NULL || access != "OP_READ")
+      {
+        reason = "the consumer does not only read '" + variableName
+            + "' through a mapping";
+        return false;
+      }
+
+      if (mapReference == NULL)
+      {
+        mapReference = consumerMap;
+      }
+      else if (mapReference->get_symbol () != consumerMap->get_symbol ())
+      {
+        reason = "the consumer reads '" + variableName
+            + "' through several mappings";
+        return false;
+      }
+    }
+    else if (access != "OP_READ" && find (read.begin (), read.end (),
+        variableName) != read.end ())
+    {
+      reason = "the consumer updates '" + variableName
+          + "', which the producer reads";
+      return false;
+    }
+  }
+
+  if (mapReference == NULL)
+  {
+    reason = "the consumer reads nothing the producer writes";
+    return false;
+  }
+
+  string const mapName = mapReference->get_symbol ()->get_name ().getString ();
+
+  try
+  {
+    OpMapDefinition * opMapDefinition = declarations->getOpMapDefinition (
+        mapName);
+
+    if (opMapDefinition->getSourceOpSetName ()
+        != consumerArguments[indexOpSet]->unparseToString ()
+        || opMapDefinition->getDestinationOpSetName ()
+            != producerArguments[indexOpSet]->unparseToString ())
+    {
+      reason = "'" + mapName
+          + "' does not map the consumer set to the producer set";
+      return false;
+    }
+  }
+  catch (string const &)
+  {
+    reason = "mapping '" + mapName + "' is not declared";
+    return false;
+  }
+
+  /*
+   * ======================================================
+   * The fused loop needs a flag telling whether the mapping
+   * reaches every producer element and, for each mapping
+   * of the producer, its composition with the consumer
+   * mapping. These are declared next to the mappings, which
+   * must therefore be declared together in a scope of the
+   * function containing the loops
+   * ======================================================
+   */
+
+  SgVariableDeclaration * mapDeclaration = getMapDeclaration (mapReference);
+
+  if (mapDeclaration == NULL || isSgGlobal (mapDeclaration->get_scope ())
+      || SageInterface::isAncestor (mapDeclaration->get_scope (), consumer)
+          == false)
+  {
+    reason = "'" + mapName
+        + "' is not declared in the function containing the loops";
+    return false;
+  }
+
+  for (vector <SgVarRefExp *>::const_iterator it = producerMaps.begin (); it
+      != producerMaps.end (); ++it)
+  {
+    SgVariableDeclaration * producerMapDeclaration = getMapDeclaration (*it);
+
+    if (producerMapDeclaration == NULL
+        || producerMapDeclaration->get_scope () != mapDeclaration->get_scope ())
+    {
+      reason = "'" + mapName + "' and '" + (*it)->unparseToString ()
+          + "' are not declared in the same scope";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void
+CPPSyntacticFusion::releaseAtEndOfScope (SgScopeStatement * scope,
+    std::string const & pointerName)
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+
+  SgStatement * release = buildFunctionCallStmt ("free", buildVoidType (),
+      buildExprListExp (buildVarRefExp (pointerName, scope)), scope);
+
+  /*
+   * ======================================================
+   * OP2 keeps the pointer handed to it, so the memory is
+   * released after OP_EXIT when the scope calls it, and
+   * otherwise when the scope is left
+   * ======================================================
+   */
+
+  Rose_STL_Container <SgNode *> functionCalls = NodeQuery::querySubTree (
+      scope, V_SgFunctionCallExp);
+
+  for (Rose_STL_Container <SgNode *>::const_iterator it =
+      functionCalls.begin (); it != functionCalls.end (); ++it)
+  {
+    SgFunctionSymbol * functionSymbol =
+        isSgFunctionCallExp (*it)->getAssociatedFunctionSymbol ();
+
+    if (functionSymbol != NULL && boost::iequals (
+        functionSymbol->get_name ().getString (), OP2::OP_EXIT))
+    {
+      insertStatementAfter (getEnclosingStatement (*it), release);
+
+      return;
+    }
+  }
+
+  SgStatement * lastStatement = getLastStatement (scope);
+
+  if (isSgReturnStmt (lastStatement) != NULL)
+  {
+    insertStatementBefore (lastStatement, release);
+  }
+  else
+  {
+    appendStatement (release, scope);
+  }
+}
+
+void
+CPPSyntacticFusion::generateMapHelpers (SgStatement * statement)
+{
+  using std::find;
+  using std::string;
+
+  SgSourceFile * sourceFile = SageInterface::getEnclosingSourceFile (statement);
+
+  if (find (filesWithMapHelpers.begin (), filesWithMapHelpers.end (),
+      sourceFile) != filesWithMapHelpers.end ())
+  {
+    return;
+  }
+
+  filesWithMapHelpers.push_back (sourceFile);
+
+  /*
+   * ======================================================
+   * The helpers are emitted in front of the first function
+   * defined in the file, so that every function of the file
+   * can call them
+   * ======================================================
+   */
+
+  SgFunctionDeclaration * firstFunction =
+      SageInterface::getEnclosingFunctionDeclaration (statement);
+
+  SgDeclarationStatementPtrList & globalDeclarations =
+      sourceFile->get_globalScope ()->get_declarations ();
+
+  for (SgDeclarationStatementPtrList::const_iterator it =
+      globalDeclarations.begin (); it != globalDeclarations.end (); ++it)
+  {
+    SgFunctionDeclaration * functionDeclaration = isSgFunctionDeclaration (*it);
+
+    if (functionDeclaration != NULL && functionDeclaration->get_definition ()
+        != NULL && functionDeclaration->get_file_info ()->get_filenameString ()
+        == sourceFile->getFileName ())
+    {
+      firstFunction = functionDeclaration;
+      break;
+    }
+  }
+
+  string code = "/* Mapping helpers for fusing loops over different sets */\n";
+
+  code += "static int *\nop_compose_maps (op_map outer, op_map inner)\n{\n";
+  code += "  int * map = (int *) malloc (outer->from->size * outer->dim * inner->dim * sizeof (int));\n";
+  code += "  for (int e = 0; e < outer->from->size * outer->dim; ++e)\n";
+  code += "    for (int i = 0; i < inner->dim; ++i)\n";
+  code += "      map[e * inner->dim + i] = inner->map[outer->map[e] * inner->dim + i];\n";
+  code += "  return map;\n}\n\n";
+
+  code += "static int\nop_map_covers (op_map map)\n{\n";
+  code += "  int covered = 1;\n";
+  code += "  char * reached = (char *) calloc (map->to->size, sizeof (char));\n";
+  code += "  for (int e = 0; e < map->from->size * map->dim; ++e)\n";
+  code += "    reached[map->map[e]] = 1;\n";
+  code += "  for (int e = 0; e < map->to->size; ++e)\n";
+  code += "    if (reached[e] == 0)\n      covered = 0;\n";
+  code += "  free (reached);\n";
+  code += "  return covered;\n}\n\n";
+
+  code += "static int *\nop_alloc_flags (op_set set)\n{\n";
+  code += "  return (int *) calloc (set->size, sizeof (int));\n}\n\n";
+
+  code += "static inline void\nop_reset_flag (int * flag)\n{\n";
+  code += "  *flag = 0;\n}\n";
+
+  SageInterface::addTextForUnparser (firstFunction, code,
+      AstUnparseAttribute::e_before);
 }
 
 void
-CPPSyntacticFusion::generateFusedKernel (SgFunctionDeclaration* subroutine1, SgFunctionDeclaration* subroutine2) {
-	using std::string;
-	using SageInterface::getScope;
-	using SageInterface::appendStatement;
-	using SageInterface::appendStatementList;
-	using SageInterface::insertStatementAfter;
-	using namespace SageBuilder;
-	
-	int i;
-	
-	SgScopeStatement* scope = getScope (subroutine2); // TODO : FIX: this assume the first kernel is defined before the second...
-	
-	SgFunctionParameterList * params = buildFunctionParameterList ();
-	
-	i = 0;
-	for (SgInitializedNamePtrList::iterator it = subroutine1->get_args ().begin (); it != subroutine1->get_args ().end (); it++)
-	{
-		params->append_arg (buildInitializedName ("k1a" + boost::lexical_cast<string> (i), (*it)->get_type ()));
-		i++;
-	}
-
-	i = 0;
-	for (SgInitializedNamePtrList::iterator it = subroutine2->get_args ().begin (); it != subroutine2->get_args ().end (); it++)
-	{
-		params->append_arg (buildInitializedName ("k2a" + boost::lexical_cast<string> (i), (*it)->get_type ()));
-		i++;
-	}
-	
-	SgFunctionDeclaration * fusedSubroutine =
-	buildDefiningFunctionDeclaration (
-									  subroutine1->get_name ().getString () + "__" + subroutine2->get_name ().getString () + "__fused",
-									  buildVoidType (),
-									  params,
-									  scope);
-	
-	fusedSubroutine->get_functionModifier ().setInline ();
-	  
-	SgBasicBlock * body = fusedSubroutine->get_definition ()->get_body ();
-	
-	SgBasicBlock * inner1 = buildBasicBlock ();
-	SgBasicBlock * inner2 = buildBasicBlock ();
-	
-	SgScopeStatement* innerScope1 = getScope (inner1);
-	SgScopeStatement* innerScope2 = getScope (inner2);
-	
-	i = 0;
-	for (SgInitializedNamePtrList::iterator it = subroutine1->get_args ().begin (); it != subroutine1->get_args ().end (); it++)
-	{
-		inner1->append_statement (buildVariableDeclaration ((*it)->get_name ().getString (), (*it)->get_type (), buildAssignInitializer (buildOpaqueVarRefExp ("k1a" + boost::lexical_cast<string> (i), innerScope1), (*it)->get_type ()), innerScope1));
-		i++;
-	}
-	appendStatement (inner1, body);
-	appendStatementList (subroutine1->get_definition ()->get_body ()->get_statements (), inner1);
-	
-	
-	i = 0;
-	for (SgInitializedNamePtrList::iterator it = subroutine2->get_args ().begin (); it != subroutine2->get_args ().end (); it++)
-	{
-		inner2->append_statement (buildVariableDeclaration ((*it)->get_name ().getString (),
-															(*it)->get_type (),
-															buildAssignInitializer (buildOpaqueVarRefExp ("k2a" + boost::lexical_cast<string> (i), innerScope2), (*it)->get_type ()), innerScope2));
-		i++;
-	}
-	appendStatement (inner2, body);
-	appendStatementList (subroutine2->get_definition ()->get_body ()->get_statements (), inner2);
-		
-	insertStatementAfter (subroutine2, fusedSubroutine, false);
+CPPSyntacticFusion::generateFusedKernel (std::string const & fusedKernelName,
+    std::vector <SgFunctionCallExp *> const & chain,
+    std::vector <std::vector <unsigned int> > const & argumentMapping,
+    SgFunctionCallExp * fusedCall)
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using boost::lexical_cast;
+  using std::find;
+  using std::string;
+  using std::vector;
+
+  Debug::getInstance ()->debugMessage ("Generating fused kernel '"
+      + fusedKernelName + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  vector <SgFunctionDeclaration *> subroutines;
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    SgFunctionDeclaration * subroutine = isSgFunctionDeclaration (
+        declarations->getSubroutine (getUserSubroutineName (*it))->get_definingDeclaration ());
+
+    ROSE_ASSERT (subroutine != NULL);
+
+    subroutines.push_back (subroutine);
+  }
+
+  /*
+   * ======================================================
+   * One formal parameter per argument of the fused call. Its
+   * type is taken from the first kernel receiving it
+   * ======================================================
+   */
+
+  unsigned int const numberOfFusedArguments =
+      fusedCall->get_args ()->get_expressions ().size () - indexFirstOpArg;
+
+  vector <SgType *> parameterTypes (numberOfFusedArguments,
+      static_cast <SgType *> (NULL));
+
+  for (unsigned int k = 0; k < subroutines.size (); ++k)
+  {
+    SgInitializedNamePtrList & arguments = subroutines[k]->get_args ();
+
+    for (unsigned int i = 0; i < arguments.size (); ++i)
+    {
+      if (parameterTypes[argumentMapping[k][i]] == NULL)
+      {
+        parameterTypes[argumentMapping[k][i]] = arguments[i]->get_type ();
+      }
+    }
+  }
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    if (find (guardedCalls.begin (), guardedCalls.end (), chain[k])
+        != guardedCalls.end ())
+    {
+      parameterTypes[argumentMapping[k].back ()] = buildPointerType (
+          buildIntType ());
+    }
+  }
+
+  SgFunctionParameterList * parameters = buildFunctionParameterList ();
+
+  for (unsigned int i = 0; i < numberOfFusedArguments; ++i)
+  {
+    parameters->append_arg (buildInitializedName ("arg" + lexical_cast <
+        string> (i), parameterTypes[i]));
+  }
+
+  /*
+   * ======================================================
+   * The kernels may be defined after the loops or in another
+   * file, so the fused kernel is defined in front of the
+   * function containing the fused loop. It is static so that
+   * fusing in several files does not clash at link time
+   * ======================================================
+   */
+
+  SgFunctionDeclaration * enclosingFunction =
+      getEnclosingFunctionDeclaration (fusedCall);
+
+  ROSE_ASSERT (enclosingFunction != NULL);
+
+  SgFunctionDeclaration * fusedSubroutine = buildDefiningFunctionDeclaration (
+      fusedKernelName, buildVoidType (), parameters, getScope (
+          enclosingFunction));
+
+  fusedSubroutine->get_declarationModifier ().get_storageModifier ().setStatic ();
+
+  fusedSubroutine->get_functionModifier ().setInline ();
+
+  SgBasicBlock * body = fusedSubroutine->get_definition ()->get_body ();
+
+  /*
+   * ======================================================
+   * Each kernel body is copied into its own block, where its
+   * formal parameters are declared as locals bound to the
+   * corresponding fused parameters
+   * ======================================================
+   */
+
+  for (unsigned int k = 0; k < subroutines.size (); ++k)
+  {
+    SgBasicBlock * innerBlock = buildBasicBlock ();
+
+    appendStatement (innerBlock, body);
+
+    SgInitializedNamePtrList & arguments = subroutines[k]->get_args ();
+
+    for (unsigned int i = 0; i < arguments.size (); ++i)
+    {
+      appendStatement (buildVariableDeclaration (
+          arguments[i]->get_name ().getString (), arguments[i]->get_type (),
+          buildAssignInitializer (buildOpaqueVarRefExp ("arg" + lexical_cast <
+              string> (argumentMapping[k][i]), innerBlock),
+              arguments[i]->get_type ()), innerBlock), innerBlock);
+    }
+
+    /*
+     * ======================================================
+     * A guarded kernel receives, as its extra last argument,
+     * the flag of the element it computes, and runs only when
+     * no earlier iteration has computed that element
+     * ======================================================
+     */
+
+    SgBasicBlock * kernelBlock = innerBlock;
+
+    if (find (guardedCalls.begin (), guardedCalls.end (), chain[k])
+        != guardedCalls.end ())
+    {
+      string const flagName = "arg" + lexical_cast <string> (
+          argumentMapping[k].back ());
+
+      kernelBlock = buildBasicBlock ();
+
+      appendStatement (buildIfStmt (buildEqualityOp (buildPointerDerefExp (
+          buildOpaqueVarRefExp (flagName, innerBlock)), buildIntVal (0)),
+          kernelBlock, NULL), innerBlock);
+
+      appendStatement (buildAssignStatement (buildPointerDerefExp (
+          buildOpaqueVarRefExp (flagName, kernelBlock)), buildIntVal (1)),
+          kernelBlock);
+    }
+
+    SgStatementPtrList & statements =
+        subroutines[k]->get_definition ()->get_body ()->get_statements ();
+
+    for (SgStatementPtrList::const_iterator it = statements.begin (); it
+        != statements.end (); ++it)
+    {
+      appendStatement (deepCopy (*it), kernelBlock);
+    }
+  }
+
+  insertStatementBefore (enclosingFunction, fusedSubroutine, false);
 }
 
 void
-CPPSyntacticFusion::removeOPParLoopCalls (ParallelLoop* parallelLoop)
+CPPSyntacticFusion::fuseOPParLoopCalls (
+    std::vector <SgFunctionCallExp *> const & chain)
 {
-	using SageInterface::removeStatement;
-	
-	for (std::vector <SgFunctionCallExp *>::const_iterator it = parallelLoop->getFirstFunctionCall ();
-		 it != parallelLoop->getLastFunctionCall ();
-		 it++)
-	{
-		removeStatement (isSgStatement ( (*it)->get_parent ()), false);
-	}
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using boost::lexical_cast;
+  using std::find;
+  using std::string;
+  using std::vector;
+
+  string fusedKernelName;
+
+  for (vector <SgFunctionCallExp *>::const_iterator it = chain.begin (); it
+      != chain.end (); ++it)
+  {
+    fusedKernelName += getUserSubroutineName (*it) + "__";
+  }
+
+  fusedKernelName += "fused";
+
+  SgFunctionCallExp * fusedCall = chain.front ();
+
+  SgScopeStatement * scope = getScope (fusedCall);
+
+  /*
+   * ======================================================
+   * Build the argument list of the fused call. An OP_ARG_DAT
+   * identical to one already passed (apart from its access)
+   * is passed once; when the accesses differ the shared
+   * argument becomes OP_RW. The mapping records, for each
+   * kernel argument, its position in the fused call
+   * ======================================================
+   */
+
+  vector <string> argumentKeys;
+
+  vector <unsigned int> argumentOwners;
+
+  vector <vector <unsigned int> > argumentMapping (chain.size ());
+
+  unsigned int sharedArguments = 0;
+
+  for (unsigned int k = 0; k < chain.size (); ++k)
+  {
+    SgExpressionPtrList const & arguments =
+        chain[k]->get_args ()->get_expressions ();
+
+    for (unsigned int i = indexFirstOpArg; i < arguments.size (); ++i)
+    {
+      SgFunctionCallExp * opArgCall = isSgFunctionCallExp (arguments[i]);
+
+      SgExpressionPtrList const & opArgArguments =
+          opArgCall->get_args ()->get_expressions ();
+
+      string key =
+          opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString ();
+
+      for (unsigned int j = 0; j + 1 < opArgArguments.size (); ++j)
+      {
+        key += "," + opArgArguments[j]->unparseToString ();
+      }
+
+      vector <string>::const_iterator position = find (argumentKeys.begin (),
+          argumentKeys.end (), key);
+
+      if (position != argumentKeys.end () && argumentOwners[position
+          - argumentKeys.begin ()] != k && boost::iequals (
+          opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+          OP2::OP_ARG_DAT))
+      {
+        unsigned int const fusedPosition = position - argumentKeys.begin ();
+
+        argumentMapping[k].push_back (fusedPosition);
+
+        SgFunctionCallExp * fusedOpArgCall = isSgFunctionCallExp (
+            fusedCall->get_args ()->get_expressions ()[indexFirstOpArg
+                + fusedPosition]);
+
+        SgExpression * fusedAccess =
+            fusedOpArgCall->get_args ()->get_expressions ().back ();
+
+        if (fusedAccess->unparseToString ()
+            != opArgArguments.back ()->unparseToString ())
+        {
+          replaceExpression (fusedAccess, buildOpaqueVarRefExp ("OP_RW",
+              scope));
+        }
+
+        sharedArguments++;
+      }
+      else
+      {
+        argumentMapping[k].push_back (argumentKeys.size ());
+
+        argumentKeys.push_back (key);
+
+        argumentOwners.push_back (k);
+
+        if (k > 0)
+        {
+          fusedCall->append_arg (deepCopy (opArgCall));
+        }
+      }
+    }
+  }
+
+  string const qualifiedKernelName =
+      getEnclosingFileNode (fusedCall)->getFileName () + ":" + fusedKernelName;
+
+  if (find (fusedKernels.begin (), fusedKernels.end (), qualifiedKernelName)
+      == fusedKernels.end ())
+  {
+    fusedKernels.push_back (qualifiedKernelName);
+
+    generateFusedKernel (fusedKernelName, chain, argumentMapping, fusedCall);
+  }
+
+  replaceExpression (fusedCall->get_args ()->get_expressions ()[0],
+      buildFunctionRefExp (fusedKernelName, scope));
+
+  replaceExpression (fusedCall->get_args ()->get_expressions ()[1],
+      buildStringVal (fusedKernelName));
+
+  for (unsigned int k = 1; k < chain.size (); ++k)
+  {
+    removeStatement (isSgStatement (chain[k]->get_parent ()));
+  }
+
+  std::cout << "Fused into '" << fusedKernelName << "': " << chain.size ()
+      << " loops, " << sharedArguments << " shared arguments" << std::endl;
+}
+
+SgFunctionCallExp *
+CPPSyntacticFusion::buildFlagOpArg (SgFunctionCallExp * opArgDatTemplate,
+    std::string const & flagName, int index, SgExpression * mapExpression,
+    std::string const & access, SgScopeStatement * scope)
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+
+  SgFunctionCallExp * opArgCall = deepCopy (opArgDatTemplate);
+
+  SgExpressionPtrList & opArgArguments =
+      opArgCall->get_args ()->get_expressions ();
+
+  replaceExpression (opArgArguments[0], buildVarRefExp (flagName, scope));
+
+  replaceExpression (opArgArguments[1], buildIntVal (index));
+
+  replaceExpression (opArgArguments[2], mapExpression);
+
+  replaceExpression (opArgArguments[3], buildIntVal (1));
+
+  replaceExpression (opArgArguments[4], buildStringVal ("int"));
+
+  replaceExpression (opArgArguments[5], buildOpaqueVarRefExp (access, scope));
+
+  return opArgCall;
 }
 
 void
-CPPSyntacticFusion::fuseOPParLoopCalls (ParallelLoop* parallelLoop1, ParallelLoop* parallelLoop2)
+CPPSyntacticFusion::fuseProducerConsumer (SgFunctionCallExp * producer,
+    SgFunctionCallExp * consumer, SgVarRefExp * mapReference)
 {
-	using SageInterface::getScope;
-	using namespace SageBuilder;
-
-	std::string kfname = parallelLoop1->getUserSubroutineName () + "__" + parallelLoop2->getUserSubroutineName () + "__fused";
-	
-	for (std::vector <SgFunctionCallExp *>::const_iterator it = parallelLoop1->getFirstFunctionCall ();
-		  it != parallelLoop1->getLastFunctionCall ();
-		  it++)
-	{
-		SgScopeStatement* scope = getScope ((*it));
-		for (int i = 0; i < parallelLoop2->getNumberOfOpDatArgumentGroups (); i++)
-		{
-			for ( int j = 0; j < parallelLoop1->getNumberOfOpDatArgumentGroups (); i++)
-			{
-				
-			}
-			
-			(*it)->append_arg ((*(parallelLoop2->getFirstFunctionCall ()))->get_args ()->get_expressions ()[i + 3]);
-		}
-		(*it)->get_args ()->get_expressions ()[0] = buildFunctionRefExp (kfname,
-																		 scope);
-		(*it)->get_args ()->get_expressions ()[1] = buildStringVal (kfname);
-
-	}
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using boost::iequals;
+  using boost::lexical_cast;
+  using std::find;
+  using std::string;
+  using std::vector;
+
+  string const mapName = mapReference->get_symbol ()->get_name ().getString ();
+
+  OpMapDefinition * opMapDefinition = declarations->getOpMapDefinition (
+      mapName);
+
+  SgVariableDeclaration * mapDeclaration = getMapDeclaration (mapReference);
+
+  SgScopeStatement * mapScope = mapDeclaration->get_scope ();
+
+  generateMapHelpers (mapDeclaration);
+
+  /*
+   * ======================================================
+   * Declare, once per mapping, whether it reaches every
+   * producer element. When it does not, the fused loop
+   * would leave some producer elements uncomputed, so the
+   * original loops are run instead
+   * ======================================================
+   */
+
+  string const coveredName = mapName + "_covered";
+
+  string const computedName = mapName + "_computed";
+
+  if (find (coveredMaps.begin (), coveredMaps.end (), mapName)
+      == coveredMaps.end ())
+  {
+    coveredMaps.push_back (mapName);
+
+    SgVariableDeclaration * coveredDeclaration = buildVariableDeclaration (
+        coveredName, buildIntType (), buildAssignInitializer (
+            buildFunctionCallExp ("op_map_covers", buildIntType (),
+                buildExprListExp (buildVarRefExp (mapName, mapScope)),
+                mapScope), buildIntType ()), mapScope);
+
+    insertStatementAfter (mapDeclaration, coveredDeclaration, false);
+
+    /*
+     * ======================================================
+     * Declare also one flag per producer element, recording
+     * whether the fused loop has already computed it
+     * ======================================================
+     */
+
+    SgVariableDeclaration * computedData = buildVariableDeclaration (
+        computedName + "_data", buildPointerType (buildIntType ()),
+        buildAssignInitializer (buildFunctionCallExp ("op_alloc_flags",
+            buildPointerType (buildIntType ()), buildExprListExp (
+                buildVarRefExp (opMapDefinition->getDestinationOpSetName (),
+                    mapScope)), mapScope), buildPointerType (buildIntType ())),
+        mapScope);
+
+    insertStatementAfter (coveredDeclaration, computedData, false);
+
+    insertStatementAfter (computedData, buildVariableDeclaration (
+        computedName, declarations->getOpDatType (), buildAssignInitializer (
+            buildFunctionCallExp (OP2::OP_DECL_DAT,
+                declarations->getOpDatType (), buildExprListExp (
+                    buildVarRefExp (opMapDefinition->getDestinationOpSetName (),
+                        mapScope), buildIntVal (1), buildStringVal ("int"),
+                    buildVarRefExp (computedName + "_data", mapScope),
+                    buildStringVal (computedName)), mapScope),
+            declarations->getOpDatType ()), mapScope), false);
+
+    releaseAtEndOfScope (mapScope, computedName + "_data");
+  }
+
+  /*
+   * ======================================================
+   * Declare, once per pair, the composition of the consumer
+   * mapping with every mapping the producer reads through,
+   * after whichever of the two is declared last
+   * ======================================================
+   */
+
+  SgExpressionPtrList const & producerArguments =
+      producer->get_args ()->get_expressions ();
+
+  for (unsigned int i = indexFirstOpArg; i < producerArguments.size (); ++i)
+  {
+    SgVarRefExp * producerMap = isSgVarRefExp (isSgFunctionCallExp (
+        producerArguments[i])->get_args ()->get_expressions ()[2]);
+
+    if (producerMap == NULL || iequals (isSgFunctionCallExp (
+        producerArguments[i])->getAssociatedFunctionSymbol ()->get_name ().getString (),
+        OP2::OP_ARG_GBL))
+    {
+      continue;
+    }
+
+    string const producerMapName =
+        producerMap->get_symbol ()->get_name ().getString ();
+
+    string const composedName = mapName + "_" + producerMapName;
+
+    if (find (composedMaps.begin (), composedMaps.end (), composedName)
+        != composedMaps.end ())
+    {
+      continue;
+    }
+
+    composedMaps.push_back (composedName);
+
+    OpMapDefinition * producerMapDefinition =
+        declarations->getOpMapDefinition (producerMapName);
+
+    SgStatement * lastDeclaration = mapDeclaration;
+
+    for (SgStatement * statement = mapDeclaration; statement != NULL; statement
+        = getNextStatement (statement))
+    {
+      if (statement == getMapDeclaration (producerMap))
+      {
+        lastDeclaration = statement;
+      }
+    }
+
+    SgVariableDeclaration * composedData = buildVariableDeclaration (
+        composedName + "_map", buildPointerType (buildIntType ()),
+        buildAssignInitializer (buildFunctionCallExp ("op_compose_maps",
+            buildPointerType (buildIntType ()), buildExprListExp (
+                buildVarRefExp (mapName, mapScope), buildVarRefExp (
+                    producerMapName, mapScope)), mapScope), buildPointerType (
+            buildIntType ())), mapScope);
+
+    attachComment (composedData, "Composition of '" + mapName + "' with '"
+        + producerMapName + "'");
+
+    insertStatementAfter (lastDeclaration, composedData, false);
+
+    insertStatementAfter (composedData, buildVariableDeclaration (
+        composedName, declarations->getOpMapType (), buildAssignInitializer (
+            buildFunctionCallExp (OP2::OP_DECL_MAP,
+                declarations->getOpMapType (), buildExprListExp (
+                    buildVarRefExp (opMapDefinition->getSourceOpSetName (),
+                        mapScope), buildVarRefExp (
+                        producerMapDefinition->getDestinationOpSetName (),
+                        mapScope), buildIntVal (opMapDefinition->getDimension ()
+                        * producerMapDefinition->getDimension ()),
+                    buildVarRefExp (composedName + "_map", mapScope),
+                    buildStringVal (composedName)), mapScope),
+            declarations->getOpMapType ()), mapScope), false);
+
+    releaseAtEndOfScope (mapScope, composedName + "_map");
+  }
+
+  /*
+   * ======================================================
+   * The two loops are guarded by the coverage flag. The
+   * fused branch clears the computed flags, then holds one
+   * copy of the producer per element reached through the
+   * mapping, iterating over the consumer set, followed by
+   * the consumer; these are then fused as a chain over the
+   * same set. Each producer copy also updates the flag of
+   * its element, so the element is computed by the first
+   * iteration reaching it only. The flag is accessed
+   * through the mapping, so the OP2 colouring keeps
+   * iterations sharing an element apart
+   * ======================================================
+   */
+
+  SgStatement * producerStatement = isSgStatement (producer->get_parent ());
+
+  SgStatement * consumerStatement = isSgStatement (consumer->get_parent ());
+
+  SgScopeStatement * scope = getScope (producerStatement);
+
+  SgBasicBlock * fusedBlock = buildBasicBlock ();
+
+  SgBasicBlock * unfusedBlock = buildBasicBlock ();
+
+  insertStatementBefore (producerStatement, buildIfStmt (buildVarRefExp (
+      coveredName, scope), fusedBlock, unfusedBlock));
+
+  SgFunctionCallExp * opArgDatTemplate = NULL;
+
+  for (unsigned int i = indexFirstOpArg; i < producerArguments.size (); ++i)
+  {
+    if (iequals (isSgFunctionCallExp (producerArguments[i])->
+        getAssociatedFunctionSymbol ()->get_name ().getString (),
+        OP2::OP_ARG_DAT))
+    {
+      opArgDatTemplate = isSgFunctionCallExp (producerArguments[i]);
+      break;
+    }
+  }
+
+  ROSE_ASSERT (opArgDatTemplate != NULL);
+
+  SgStatement * resetStatement = deepCopy (producerStatement);
+
+  appendStatement (resetStatement, fusedBlock);
+
+  SgFunctionCallExp * resetCall = getParallelLoopCall (resetStatement);
+
+  SgExpressionPtrList & resetArguments =
+      resetCall->get_args ()->get_expressions ();
+
+  resetArguments.erase (resetArguments.begin () + indexFirstOpArg + 1,
+      resetArguments.end ());
+
+  replaceExpression (resetArguments[0], buildOpaqueVarRefExp ("op_reset_flag",
+      scope));
+
+  replaceExpression (resetArguments[1], buildStringVal ("op_reset_flag"));
+
+  replaceExpression (resetArguments[indexFirstOpArg], buildFlagOpArg (
+      opArgDatTemplate, computedName, -1, buildOpaqueVarRefExp ("OP_ID",
+          scope), "OP_WRITE", scope));
+
+  vector <SgFunctionCallExp *> chain;
+
+  for (unsigned int j = 0; j < opMapDefinition->getDimension (); ++j)
+  {
+    SgStatement * producerCopy = deepCopy (producerStatement);
+
+    appendStatement (producerCopy, fusedBlock);
+
+    SgFunctionCallExp * producerCopyCall = getParallelLoopCall (producerCopy);
+
+    SgExpressionPtrList & arguments =
+        producerCopyCall->get_args ()->get_expressions ();
+
+    replaceExpression (arguments[indexOpSet], deepCopy (
+        consumer->get_args ()->get_expressions ()[indexOpSet]));
+
+    for (unsigned int i = indexFirstOpArg; i < arguments.size (); ++i)
+    {
+      SgFunctionCallExp * opArgCall = isSgFunctionCallExp (arguments[i]);
+
+      if (iequals (
+          opArgCall->getAssociatedFunctionSymbol ()->get_name ().getString (),
+          OP2::OP_ARG_GBL))
+      {
+        continue;
+      }
+
+      SgExpressionPtrList & opArgArguments =
+          opArgCall->get_args ()->get_expressions ();
+
+      SgVarRefExp * producerMap = isSgVarRefExp (opArgArguments[2]);
+
+      if (producerMap == NULL)
+      {
+        replaceExpression (opArgArguments[1], buildIntVal (j));
+
+        replaceExpression (opArgArguments[2], buildVarRefExp (mapName, scope));
+      }
+      else
+      {
+        string const producerMapName =
+            producerMap->get_symbol ()->get_name ().getString ();
+
+        int const index = j * declarations->getOpMapDefinition (
+            producerMapName)->getDimension () + lexical_cast <int> (
+            opArgArguments[1]->unparseToString ());
+
+        replaceExpression (opArgArguments[1], buildIntVal (index));
+
+        replaceExpression (opArgArguments[2], buildVarRefExp (mapName + "_"
+            + producerMapName, scope));
+      }
+    }
+
+    producerCopyCall->append_arg (buildFlagOpArg (opArgDatTemplate,
+        computedName, j, buildVarRefExp (mapName, scope), "OP_RW", scope));
+
+    guardedCalls.push_back (producerCopyCall);
+
+    chain.push_back (producerCopyCall);
+  }
+
+  SgStatement * consumerCopy = deepCopy (consumerStatement);
+
+  appendStatement (consumerCopy, fusedBlock);
+
+  chain.push_back (getParallelLoopCall (consumerCopy));
+
+  removeStatement (producerStatement);
+
+  removeStatement (consumerStatement);
+
+  appendStatement (producerStatement, unfusedBlock);
+
+  appendStatement (consumerStatement, unfusedBlock);
+
+  std::cout << "Fusing producer '" << getUserSubroutineName (producer)
+      << "' into consumer '" << getUserSubroutineName (consumer)
+      << "' through '" << mapName << "'" << std::endl;
+
+  fuseOPParLoopCalls (chain);
 }
 
 void
-CPPSyntacticFusion::fuseLoops (std::string const & subroutine1, std::string const & subroutine2)
+CPPSyntacticFusion::fuseChains (std::vector <SgFunctionCallExp *> const & run)
 {
-	using boost::iequals;
-	
-	Debug::getInstance ()->debugMessage ("Syntactic Kernel Fusion :'" + subroutine1 + "' & '" + subroutine2 + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
-	generateFusedKernel (declarations->getSubroutine (subroutine1), declarations->getSubroutine (subroutine2));
-	
-	removeOPParLoopCalls (declarations->getParallelLoop (subroutine2));
-	fuseOPParLoopCalls (
-						declarations->getParallelLoop (subroutine1),
-						declarations->getParallelLoop (subroutine2));
+  using boost::split;
+  using boost::algorithm::is_any_of;
+  using std::string;
+  using std::vector;
+
+  /*
+   * ======================================================
+   * With explicitly named kernels only chains formed by
+   * exactly those kernels, in that order, are fused;
+   * otherwise maximal legal chains are fused greedily
+   * ======================================================
+   */
+
+  vector <string> requestedKernels;
+
+  if (Globals::getInstance ()->syntacticFusion ())
+  {
+    string const kernels = Globals::getInstance ()->getSyntacticFusionKernels ();
+
+    split (requestedKernels, kernels, is_any_of (":"));
+  }
+
+  vector <SgFunctionCallExp *> chain;
+
+  for (unsigned int i = 0; i <= run.size (); ++i)
+  {
+    string reason;
+
+    bool extendChain = i < run.size () && chain.empty () == false;
+
+    if (extendChain && requestedKernels.empty () == false)
+    {
+      extendChain = chain.size () < requestedKernels.size ()
+          && getUserSubroutineName (run[i]) == requestedKernels[chain.size ()];
+    }
+
+    if (extendChain)
+    {
+      extendChain = isFusionLegal (chain, run[i], reason);
+
+      SgVarRefExp * mapReference;
+
+      if (extendChain == false && chain.size () == 1
+          && isProducerConsumerFusionLegal (chain.front (), run[i],
+              mapReference, reason))
+      {
+        fuseProducerConsumer (chain.front (), run[i], mapReference);
+
+        chain.clear ();
+
+        continue;
+      }
+
+      if (extendChain == false)
+      {
+        std::cout << "Not fusing '" << getUserSubroutineName (run[i])
+            << "' with the preceding loop: " << reason << std::endl;
+      }
+    }
+
+    if (extendChain)
+    {
+      chain.push_back (run[i]);
+    }
+    else
+    {
+      if (chain.size () > 1 && (requestedKernels.empty () || chain.size ()
+          == requestedKernels.size ()))
+      {
+        fuseOPParLoopCalls (chain);
+      }
+
+      chain.clear ();
+
+      if (i < run.size () && (requestedKernels.empty ()
+          || getUserSubroutineName (run[i]) == requestedKernels.front ()))
+      {
+        chain.push_back (run[i]);
+      }
+    }
+  }
 }
 
-CPPSyntacticFusion::CPPSyntacticFusion (SgProject* project, CPPProgramDeclarationsAndDefinitions * declarations) : project (project), declarations (declarations)
+CPPSyntacticFusion::CPPSyntacticFusion (SgProject * project,
+    CPPProgramDeclarationsAndDefinitions * declarations) :
+  project (project), declarations (declarations)
 {
-	using namespace SageBuilder;
-	using SageInterface::appendStatement;
-	using std::string;
-	
-	Debug::getInstance ()->debugMessage ("Syntactic Kernel Fusion :'" + Globals::getInstance ()->getSyntacticFusionKernels () + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
-	
-	std::vector<string> splits;
-	string arg = Globals::getInstance ()->getSyntacticFusionKernels ();
-	boost::split( splits, arg, boost::algorithm::is_any_of(":"));
-	fuseLoops (splits[0], splits[1]);
-}
\ No newline at end of file
+  using std::vector;
+
+  Debug::getInstance ()->debugMessage ("Fusing consecutive OP_PAR_LOOPs",
+      Debug::CONSTRUCTOR_LEVEL, __FILE__, __LINE__);
+
+  traverseInputFiles (project, preorder);
+
+  for (vector <SgBasicBlock *>::const_iterator it = basicBlocks.begin (); it
+      != basicBlocks.end (); ++it)
+  {
+    /*
+     * ======================================================
+     * Collect the runs of OP_PAR_LOOP calls not separated by
+     * any other statement
+     * ======================================================
+     */
+
+    vector <vector <SgFunctionCallExp *> > runs (1);
+
+    SgStatementPtrList & statements = (*it)->get_statements ();
+
+    for (SgStatementPtrList::const_iterator statement = statements.begin (); statement
+        != statements.end (); ++statement)
+    {
+      SgFunctionCallExp * parallelLoopCall = getParallelLoopCall (*statement);
+
+      if (parallelLoopCall != NULL)
+      {
+        runs.back ().push_back (parallelLoopCall);
+      }
+      else if (runs.back ().empty () == false)
+      {
+        runs.push_back (vector <SgFunctionCallExp *> ());
+      }
+    }
+
+    for (vector <vector <SgFunctionCallExp *> >::const_iterator run =
+        runs.begin (); run != runs.end (); ++run)
+    {
+      if (run->size () > 1)
+      {
+        fuseChains (*run);
+      }
+    }
+  }
+}
@@ -35,6 +35,7 @@
 #define CPP_SYNTACTIC_FUSION_H
 
 #include <string>
+#include <vector>
 #include <rose.h>
 #include "CPPParallelLoop.h"
 #include "OP2Definitions.h"
@@ -44,29 +45,122 @@ class CPPProgramDeclarationsAndDefinitions;
 class CPPSyntacticFusion: public AstSimpleProcessing
 {
   private:
-	SgProject* project;
-	    
-    CPPProgramDeclarationsAndDefinitions* declarations;
-    
+
+    /*
+     * ======================================================
+     * In an OP_PAR_LOOP call the user kernel appears in
+     * position 0, its name in position 1, the iteration set
+     * in position 2 and the OP_ARG calls from position 3
+     * ======================================================
+     */
+    static unsigned int const indexOpSet = 2;
+
+    static unsigned int const indexFirstOpArg = 3;
+
+    SgProject * project;
+
+    CPPProgramDeclarationsAndDefinitions * declarations;
+
+    /*
+     * ======================================================
+     * Basic blocks in which runs of consecutive OP_PAR_LOOP
+     * calls are looked for
+     * ======================================================
+     */
+    std::vector <SgBasicBlock *> basicBlocks;
+
+    /*
+     * ======================================================
+     * Names of the fused kernels generated so far, qualified
+     * by the file defining them, so that a chain occurring
+     * several times in a file is generated once
+     * ======================================================
+     */
+    std::vector <std::string> fusedKernels;
+
+    /*
+     * ======================================================
+     * Mappings for which a coverage flag, and pairs of
+     * mappings for which a composed mapping, has already been
+     * declared
+     * ======================================================
+     */
+    std::vector <std::string> coveredMaps;
+
+    std::vector <std::string> composedMaps;
+
+    /*
+     * ======================================================
+     * Source files into which the mapping helpers used by
+     * producer/consumer fusion have been emitted
+     * ======================================================
+     */
+    std::vector <SgSourceFile *> filesWithMapHelpers;
+
+    /*
+     * ======================================================
+     * Producer copies created by producer/consumer fusion,
+     * whose last argument is the computed flag of the element
+     * they produce
+     * ======================================================
+     */
+    std::vector <SgFunctionCallExp *> guardedCalls;
+
+  private:
+
     virtual void
-    visit (SgNode* node);
-	
-	void
-	generateFusedKernel (SgFunctionDeclaration* subroutine1, SgFunctionDeclaration* subroutine2);
-    
-	void
-	removeOPParLoopCalls (ParallelLoop* parallelLoop);
-	
-	void
-	fuseOPParLoopCalls (ParallelLoop* parallelLoop1, ParallelLoop* parallelLoop2);
-	
-	void
-	fuseLoops (std::string const & subroutine1, std::string const & subroutine2);
-	
+    visit (SgNode * node);
+
+    SgFunctionCallExp *
+    getParallelLoopCall (SgStatement * statement);
+
+    std::string
+    getUserSubroutineName (SgFunctionCallExp * parallelLoopCall);
+
+    bool
+    isFusionLegal (std::vector <SgFunctionCallExp *> const & chain,
+        SgFunctionCallExp * candidate, std::string & reason);
+
+    SgVariableDeclaration *
+    getMapDeclaration (SgVarRefExp * mapReference);
+
+    bool
+    isProducerConsumerFusionLegal (SgFunctionCallExp * producer,
+        SgFunctionCallExp * consumer, SgVarRefExp * & mapReference,
+        std::string & reason);
+
+    void
+    releaseAtEndOfScope (SgScopeStatement * scope,
+        std::string const & pointerName);
+
+    void
+    generateMapHelpers (SgStatement * statement);
+
+    void
+    generateFusedKernel (std::string const & fusedKernelName,
+        std::vector <SgFunctionCallExp *> const & chain,
+        std::vector <std::vector <unsigned int> > const & argumentMapping,
+        SgFunctionCallExp * fusedCall);
+
+    void
+    fuseOPParLoopCalls (std::vector <SgFunctionCallExp *> const & chain);
+
+    SgFunctionCallExp *
+    buildFlagOpArg (SgFunctionCallExp * opArgDatTemplate,
+        std::string const & flagName, int index, SgExpression * mapExpression,
+        std::string const & access, SgScopeStatement * scope);
+
+    void
+    fuseProducerConsumer (SgFunctionCallExp * producer,
+        SgFunctionCallExp * consumer, SgVarRefExp * mapReference);
+
+    void
+    fuseChains (std::vector <SgFunctionCallExp *> const & run);
+
   public:
-    
-    CPPSyntacticFusion (SgProject* project,
-                   CPPProgramDeclarationsAndDefinitions* declarations);
+
+    CPPSyntacticFusion (SgProject * project,
+        CPPProgramDeclarationsAndDefinitions * declarations);
 };
 
-#endif
\ No newline at end of file
+#endif
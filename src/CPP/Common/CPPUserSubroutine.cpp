@@ -199,7 +199,14 @@ CPPUserSubroutine::CPPUserSubroutine (SgScopeStatement * moduleScope,
       this->subroutineName.c_str (), buildVoidType (), formalParameters,
       moduleScope);
 
-  appendStatement (subroutineHeaderStatement, moduleScope);
+  /*
+   * ======================================================
+   * The subroutine is built detached from the module scope,
+   * into which it is inserted once every loop is built
+   * ======================================================
+   */
+
+  subroutineHeaderStatement->set_parent (moduleScope);
 
   subroutineScope = subroutineHeaderStatement->get_definition ()->get_body ();
 
@@ -44,6 +44,7 @@
 #include "RoseStatementsAndExpressionsBuilder.h"
 #include "OP2Definitions.h"
 #include "OP2.h"
+#include "Statistics.h"
 
 void
 CPPOpenCLSubroutinesGeneration::addFreeVariableDeclarations ()
@@ -101,49 +102,99 @@ CPPOpenCLSubroutinesGeneration::createSubroutines ()
   using std::string;
   using std::map;
 
+  Statistics::getInstance ()->beginPhase ("reductions");
+
   createReductionSubroutines ();
 
+  Statistics::getInstance ()->endPhase ();
+
   for (map <string, ParallelLoop *>::const_iterator it =
       declarations->firstParallelLoop (); it
       != declarations->lastParallelLoop (); ++it)
   {
     string const userSubroutineName = it->first;
 
+    Statistics::getInstance ()->beginPhase ("loop " + userSubroutineName);
+
     Debug::getInstance ()->debugMessage ("Analysing user subroutine '"
         + userSubroutineName + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
     CPPParallelLoop * parallelLoop =
         static_cast <CPPParallelLoop *> (it->second);
 
+    Statistics::getInstance ()->beginPhase ("user");
+
     CPPOpenCLUserSubroutine * userDeviceSubroutine =
         new CPPOpenCLUserSubroutine (moduleScope, parallelLoop, declarations);
 
+    Statistics::getInstance ()->endPhase ();
+
     userSubroutines[userSubroutineName] = userDeviceSubroutine;
 
+    userDeviceSubroutine = static_cast <CPPOpenCLUserSubroutine *> (
+        shareUserSubroutine (userDeviceSubroutine));
+
     CPPOpenCLKernelSubroutine * kernelSubroutine;
 
     if (parallelLoop->isDirectLoop ())
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPOpenCLKernelSubroutineDirectLoop (moduleScope,
           userDeviceSubroutine, parallelLoop, reductionSubroutines,
           declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPOpenCLHostSubroutineDirectLoop (moduleScope,
               kernelSubroutine, parallelLoop, moduleDeclarations,
               userDeviceSubroutine, constantDeclarations, declarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
     else
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPOpenCLKernelSubroutineIndirectLoop (
           moduleScope, userDeviceSubroutine, parallelLoop,
           reductionSubroutines, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPOpenCLHostSubroutineIndirectLoop (moduleScope,
               kernelSubroutine, parallelLoop, moduleDeclarations,
               userDeviceSubroutine, constantDeclarations, declarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
+
+    addBuiltSubroutine (kernelSubroutine->getSubroutineHeaderStatement ());
+
+    addBuiltSubroutine (
+        hostSubroutines[userSubroutineName]->getSubroutineHeaderStatement ());
+
+    /*
+     * ======================================================
+     * Only the header statements and names of the generated
+     * subroutines are needed from now on, so the state used
+     * to build them is released before the next loop
+     * ======================================================
+     */
+
+    hostSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    userSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    delete kernelSubroutine;
+
+    Statistics::getInstance ()->endPhase ();
   }
 }
 
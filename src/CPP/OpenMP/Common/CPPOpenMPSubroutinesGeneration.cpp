@@ -41,6 +41,7 @@
 #include "RoseStatementsAndExpressionsBuilder.h"
 #include "OpenMP.h"
 #include "OP2Definitions.h"
+#include "Statistics.h"
 
 void
 CPPOpenMPSubroutinesGeneration::addFreeVariableDeclarations ()
@@ -98,37 +99,82 @@ CPPOpenMPSubroutinesGeneration::createSubroutines ()
   {
     string const userSubroutineName = it->first;
 
+    Statistics::getInstance ()->beginPhase ("loop " + userSubroutineName);
+
     Debug::getInstance ()->debugMessage ("Analysing user subroutine '"
         + userSubroutineName + "'", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
     CPPParallelLoop * parallelLoop =
         static_cast <CPPParallelLoop *> (it->second);
 
+    Statistics::getInstance ()->beginPhase ("user");
+
     CPPUserSubroutine * userSubroutine = new CPPUserSubroutine (moduleScope,
         parallelLoop, declarations);
 
+    Statistics::getInstance ()->endPhase ();
+
     userSubroutines[userSubroutineName] = userSubroutine;
 
+    userSubroutine = shareUserSubroutine (userSubroutine);
+
     CPPOpenMPKernelSubroutine * kernelSubroutine;
 
     if (parallelLoop->isDirectLoop ())
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPOpenMPKernelSubroutineDirectLoop (moduleScope,
           userSubroutine, parallelLoop);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPOpenMPHostSubroutineDirectLoop (moduleScope,
               kernelSubroutine, parallelLoop, moduleDeclarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
     else
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new CPPOpenMPKernelSubroutineIndirectLoop (
           moduleScope, userSubroutine, parallelLoop);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new CPPOpenMPHostSubroutineIndirectLoop (moduleScope,
               kernelSubroutine, parallelLoop, moduleDeclarations);
+
+      Statistics::getInstance ()->endPhase ();
     }
+
+    addBuiltSubroutine (kernelSubroutine->getSubroutineHeaderStatement ());
+
+    addBuiltSubroutine (
+        hostSubroutines[userSubroutineName]->getSubroutineHeaderStatement ());
+
+    /*
+     * ======================================================
+     * Only the header statements and names of the generated
+     * subroutines are needed from now on, so the state used
+     * to build them is released before the next loop
+     * ======================================================
+     */
+
+    hostSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    userSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    delete kernelSubroutine;
+
+    Statistics::getInstance ()->endPhase ();
   }
 }
 
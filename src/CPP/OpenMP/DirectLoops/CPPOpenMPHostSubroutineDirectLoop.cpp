@@ -37,6 +37,7 @@
 #include "CompilerGeneratedNames.h"
 #include "OpenMP.h"
 #include "OP2.h"
+#include <boost/lexical_cast.hpp>
 
 void
 CPPOpenMPHostSubroutineDirectLoop::createKernelFunctionCallStatement (
@@ -86,6 +87,68 @@ CPPOpenMPHostSubroutineDirectLoop::createKernelFunctionCallStatement (
   appendStatement (buildExprStatement (functionCallExpression), scope);
 }
 
+SgExpression *
+CPPOpenMPHostSubroutineDirectLoop::buildSetSizeExpression ()
+{
+  using namespace SageBuilder;
+  using namespace OP2VariableNames;
+  using namespace OP2::RunTimeVariableNames;
+
+  /*
+   * ======================================================
+   * When the size of the iteration set is known at
+   * translation time the slice bounds fold to constants
+   * ======================================================
+   */
+
+  if (parallelLoop->getIterationSetSize () > 0)
+  {
+    return buildIntVal (parallelLoop->getIterationSetSize ());
+  }
+
+  return buildArrowExp (variableDeclarations->getReference (set),
+      buildOpaqueVarRefExp (size, subroutineScope));
+}
+
+void
+CPPOpenMPHostSubroutineDirectLoop::createSetSizeCheckStatement ()
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using namespace OP2VariableNames;
+  using namespace OP2::RunTimeVariableNames;
+  using boost::lexical_cast;
+  using std::string;
+
+  Debug::getInstance ()->debugMessage (
+      "Creating check of the specialised iteration set size",
+      Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  string const expectedSize = lexical_cast <string> (
+      parallelLoop->getIterationSetSize ());
+
+  SgNotEqualOp * sizeDiffersExpression = buildNotEqualOp (buildArrowExp (
+      variableDeclarations->getReference (set), buildOpaqueVarRefExp (size,
+          subroutineScope)), buildIntVal (
+      parallelLoop->getIterationSetSize ()));
+
+  SgBasicBlock * ifBody = buildBasicBlock ();
+
+  SgExprListExp * printfArguments = buildExprListExp (buildStringVal (
+      "error: loop " + parallelLoop->getUserSubroutineName ()
+          + " was translated for a set of size " + expectedSize + "\\n"));
+
+  appendStatement (buildExprStatement (buildFunctionCallExp ("printf",
+      buildVoidType (), printfArguments, subroutineScope)), ifBody);
+
+  appendStatement (buildExprStatement (buildFunctionCallExp ("exit",
+      buildVoidType (), buildExprListExp (buildIntVal (1)), subroutineScope)),
+      ifBody);
+
+  appendStatement (buildIfStmt (buildExprStatement (sizeDiffersExpression),
+      ifBody, NULL), subroutineScope);
+}
+
 void
 CPPOpenMPHostSubroutineDirectLoop::createOpenMPLoopStatements ()
 {
@@ -99,6 +162,11 @@ CPPOpenMPHostSubroutineDirectLoop::createOpenMPLoopStatements ()
   Debug::getInstance ()->debugMessage ("Creating OpenMP for loop statements",
       Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
+  if (parallelLoop->getIterationSetSize () > 0)
+  {
+    createSetSizeCheckStatement ();
+  }
+
   SgBasicBlock * loopBody = buildBasicBlock ();
 
   /*
@@ -107,11 +175,7 @@ CPPOpenMPHostSubroutineDirectLoop::createOpenMPLoopStatements ()
    * ======================================================
    */
 
-  SgArrowExp * arrowExpression1 = buildArrowExp (
-      variableDeclarations->getReference (set), buildOpaqueVarRefExp (size,
-          subroutineScope));
-
-  SgMultiplyOp * multiplyExpression1 = buildMultiplyOp (arrowExpression1,
+  SgMultiplyOp * multiplyExpression1 = buildMultiplyOp (buildSetSizeExpression (),
       variableDeclarations->getReference (getIterationCounterVariableName (1)));
 
   SgDivideOp * divideExpression1 = buildDivideOp (multiplyExpression1,
@@ -128,15 +192,11 @@ CPPOpenMPHostSubroutineDirectLoop::createOpenMPLoopStatements ()
    * ======================================================
    */
 
-  SgArrowExp * arrowExpression2 = buildArrowExp (
-      variableDeclarations->getReference (set), buildOpaqueVarRefExp (size,
-          subroutineScope));
-
   SgAddOp * addExpression2 = buildAddOp (variableDeclarations->getReference (
       getIterationCounterVariableName (1)), buildIntVal (1));
 
-  SgMultiplyOp * multiplyExpression2 = buildMultiplyOp (arrowExpression2,
-      addExpression2);
+  SgMultiplyOp * multiplyExpression2 = buildMultiplyOp (
+      buildSetSizeExpression (), addExpression2);
 
   SgDivideOp * divideExpression2 = buildDivideOp (multiplyExpression2,
       variableDeclarations->getReference (numberOfThreads));
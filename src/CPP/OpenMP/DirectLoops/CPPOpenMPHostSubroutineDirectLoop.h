@@ -46,6 +46,12 @@ class CPPOpenMPHostSubroutineDirectLoop: public CPPOpenMPHostSubroutine
     virtual void
     createKernelFunctionCallStatement (SgScopeStatement * scope);
 
+    SgExpression *
+    buildSetSizeExpression ();
+
+    void
+    createSetSizeCheckStatement ();
+
     void
     createOpenMPLoopStatements ();
 
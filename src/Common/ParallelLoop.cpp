@@ -45,6 +45,10 @@ ParallelLoop::ParallelLoop (SgFunctionCallExp * functionCallExpression)
 
   functionCallExpressions.push_back (functionCallExpression);
 
+  iterationSetSize = 0;
+
+  iterationSetSizesConflict = false;
+
   SgExpressionPtrList & actualArguments =
       functionCallExpression->get_args ()->get_expressions ();
 
@@ -151,6 +155,34 @@ ParallelLoop::getOpDatBaseType (unsigned int OP_DAT_ArgumentGroup)
   }
 }
 
+void
+ParallelLoop::setOpDatComputeType (unsigned int OP_DAT_ArgumentGroup,
+    SgType * type)
+{
+  OpDatComputeTypes[OP_DAT_ArgumentGroup] = type;
+}
+
+SgType *
+ParallelLoop::getOpDatComputeType (unsigned int OP_DAT_ArgumentGroup)
+{
+  if (isMixedPrecision (OP_DAT_ArgumentGroup))
+  {
+    return OpDatComputeTypes[OP_DAT_ArgumentGroup];
+  }
+
+  return getOpDatBaseType (OP_DAT_ArgumentGroup);
+}
+
+bool
+ParallelLoop::isMixedPrecision (unsigned int OP_DAT_ArgumentGroup)
+{
+  std::map <unsigned int, SgType *>::const_iterator it = OpDatComputeTypes.find (
+      OP_DAT_ArgumentGroup);
+
+  return it != OpDatComputeTypes.end () && it->second->variantT ()
+      != getOpDatBaseType (OP_DAT_ArgumentGroup)->variantT ();
+}
+
 void
 ParallelLoop::setOpDatDimension (unsigned int OP_DAT_ArgumentGroup,
     unsigned int dimension)
@@ -183,6 +215,45 @@ ParallelLoop::setOpMapValue (unsigned int OP_DAT_ArgumentGroup,
   OpDatMappingDescriptors[OP_DAT_ArgumentGroup] = value;
 }
 
+void
+ParallelLoop::setIterationSetSize (unsigned int size)
+{
+  iterationSetSize = size;
+}
+
+void
+ParallelLoop::mergeIterationSetSize (unsigned int size)
+{
+  if (size != iterationSetSize)
+  {
+    iterationSetSizesConflict = true;
+  }
+
+  if (iterationSetSizesConflict)
+  {
+    iterationSetSize = 0;
+  }
+}
+
+unsigned int
+ParallelLoop::getIterationSetSize () const
+{
+  return iterationSetSize;
+}
+
+void
+ParallelLoop::setOpMapVariableName (unsigned int OP_DAT_ArgumentGroup,
+    std::string const variableName)
+{
+  OpMapVariableNames[OP_DAT_ArgumentGroup] = variableName;
+}
+
+std::string
+ParallelLoop::getOpMapVariableName (unsigned int OP_DAT_ArgumentGroup)
+{
+  return OpMapVariableNames[OP_DAT_ArgumentGroup];
+}
+
 bool
 ParallelLoop::isIndirect (unsigned int OP_DAT_ArgumentGroup)
 {
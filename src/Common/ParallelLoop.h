@@ -97,6 +97,15 @@ class ParallelLoop
      */
     std::map <unsigned int, SgType *> OpDatTypes;
 
+    /*
+     * ======================================================
+     * The type in which generated kernels compute on each
+     * OP_DAT when it differs from the type in which it is
+     * stored. The map is indexed by the argument group number
+     * ======================================================
+     */
+    std::map <unsigned int, SgType *> OpDatComputeTypes;
+
     /*
      * ======================================================
      * The dimension of each OP_DAT. The map is indexed by
@@ -124,6 +133,15 @@ class ParallelLoop
      */
     std::map <unsigned int, MAPPING_VALUE> OpDatMappingDescriptors;
 
+    /*
+     * ======================================================
+     * What is the name of the OP_MAP through which the
+     * OP_DAT in this position is accessed? Only set for
+     * indirect OP_DAT argument groups
+     * ======================================================
+     */
+    std::map <unsigned int, std::string> OpMapVariableNames;
+
     /*
      * ======================================================
      * How is the data for the OP_DAT variables in this position
@@ -154,6 +172,22 @@ class ParallelLoop
      */
     unsigned int numberOfOpDats;
 
+    /*
+     * ======================================================
+     * The size of the set every call iterates over, or zero
+     * if it is not known before the program runs
+     * ======================================================
+     */
+    unsigned int iterationSetSize;
+
+    /*
+     * ======================================================
+     * Whether two calls iterate over sets of different sizes,
+     * after which the size stays unknown
+     * ======================================================
+     */
+    bool iterationSetSizesConflict;
+
   protected:
 
     ParallelLoop (SgFunctionCallExp * functionCallExpression);
@@ -212,6 +246,28 @@ class ParallelLoop
     SgType *
     getOpDatBaseType (unsigned int OP_DAT_ArgumentGroup);
 
+    void
+    setOpDatComputeType (unsigned int OP_DAT_ArgumentGroup, SgType * type);
+
+    /*
+     * ======================================================
+     * What is the type in which generated kernels compute on
+     * the OP_DAT in this argument group? Unless a precision
+     * policy says otherwise this is its base type
+     * ======================================================
+     */
+    SgType *
+    getOpDatComputeType (unsigned int OP_DAT_ArgumentGroup);
+
+    /*
+     * ======================================================
+     * Is the OP_DAT in this argument group stored in one
+     * precision but computed on in another?
+     * ======================================================
+     */
+    bool
+    isMixedPrecision (unsigned int OP_DAT_ArgumentGroup);
+
     void
     setOpDatDimension (unsigned int OP_DAT_ArgumentGroup,
         unsigned int dimension);
@@ -241,6 +297,42 @@ class ParallelLoop
     void
     setOpMapValue (unsigned int OP_DAT_ArgumentGroup, MAPPING_VALUE value);
 
+    void
+    setIterationSetSize (unsigned int size);
+
+    /*
+     * ======================================================
+     * Records the size of the set iterated over by a further
+     * call to this OP_PAR_LOOP. Once two calls disagree the
+     * size is unknown, whatever later calls iterate over
+     * ======================================================
+     */
+    void
+    mergeIterationSetSize (unsigned int size);
+
+    /*
+     * ======================================================
+     * The size of the set iterated over, if every call to
+     * this OP_PAR_LOOP iterates over a set whose size is
+     * known before the program runs; zero otherwise
+     * ======================================================
+     */
+    unsigned int
+    getIterationSetSize () const;
+
+    void
+    setOpMapVariableName (unsigned int OP_DAT_ArgumentGroup,
+        std::string const variableName);
+
+    /*
+     * ======================================================
+     * What is the name of the OP_MAP variable in this
+     * indirect OP_DAT argument group?
+     * ======================================================
+     */
+    std::string
+    getOpMapVariableName (unsigned int OP_DAT_ArgumentGroup);
+
     bool
     isIndirect (unsigned int OP_DAT_ArgumentGroup);
 
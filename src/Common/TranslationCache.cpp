@@ -0,0 +1,416 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "TranslationCache.h"
+#include "Debug.h"
+#include "Globals.h"
+#include "Exceptions.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <climits>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace
+{
+  /*
+   * ======================================================
+   * Changes whenever the layout of a cache entry changes
+   * ======================================================
+   */
+  char const * const cacheFormat = "translation-cache-1";
+
+  boost::uint64_t const offsetBasis = 14695981039346656037ULL;
+
+  boost::uint64_t const prime = 1099511628211ULL;
+
+  /*
+   * ======================================================
+   * Returns the path of the running translator, or an empty
+   * string when it cannot be found. 'argv[0]' alone is not
+   * enough: when the translator is run through $PATH it
+   * holds a bare name
+   * ======================================================
+   */
+  std::string
+  getExecutablePath (std::string const & programName)
+  {
+    using boost::filesystem::exists;
+    using boost::filesystem::is_regular;
+    using boost::filesystem::path;
+    using boost::filesystem::system_complete;
+    using boost::split;
+    using boost::is_any_of;
+    using std::string;
+    using std::vector;
+
+    char buffer[PATH_MAX];
+
+    ssize_t const length = readlink ("/proc/self/exe", buffer,
+        sizeof (buffer) - 1);
+
+    if (length > 0)
+    {
+      buffer[length] = '\0';
+
+      return string (buffer);
+    }
+
+    if (programName.find ('/') != string::npos)
+    {
+      path const translator = system_complete (path (programName));
+
+      return exists (translator) ? translator.string () : string ();
+    }
+
+    char const * const searchPath = getenv ("PATH");
+
+    if (searchPath == NULL)
+    {
+      return string ();
+    }
+
+    vector <string> directories;
+
+    split (directories, string (searchPath), is_any_of (":"));
+
+    for (vector <string>::const_iterator it = directories.begin (); it
+        != directories.end (); ++it)
+    {
+      path const translator = path (it->empty () ? "." : *it) / programName;
+
+      if (exists (translator) && is_regular (translator))
+      {
+        return system_complete (translator).string ();
+      }
+    }
+
+    return string ();
+  }
+}
+
+void
+TranslationCache::addToHash (std::string const & text)
+{
+  for (std::string::const_iterator it = text.begin (); it != text.end (); ++it)
+  {
+    hash ^= static_cast <unsigned char> (*it);
+
+    hash *= prime;
+  }
+
+  /*
+   * ======================================================
+   * Terminate each item so that 'ab','c' and 'a','bc'
+   * hash differently
+   * ======================================================
+   */
+
+  hash ^= 0xff;
+
+  hash *= prime;
+}
+
+void
+TranslationCache::addFileToHash (std::string const & fileName)
+{
+  using boost::filesystem::path;
+  using boost::filesystem::system_complete;
+  using boost::starts_with;
+  using boost::trim_copy;
+  using std::ifstream;
+  using std::string;
+  using std::vector;
+
+  string const completeName = system_complete (path (fileName)).string ();
+
+  if (hashedFiles.insert (completeName).second == false)
+  {
+    return;
+  }
+
+  ifstream inputFile (completeName.c_str ());
+
+  if (inputFile.is_open () == false)
+  {
+    return;
+  }
+
+  Debug::getInstance ()->debugMessage ("Hashing '" + completeName + "'",
+      Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  addToHash (completeName);
+
+  vector <string> includedFiles;
+
+  string line;
+
+  while (getline (inputFile, line))
+  {
+    addToHash (line);
+
+    /*
+     * ======================================================
+     * User kernels are normally in headers included with
+     * quotes, which must be part of the key as well
+     * ======================================================
+     */
+
+    string const trimmedLine = trim_copy (line);
+
+    if (starts_with (trimmedLine, "#include \""))
+    {
+      size_t const first = trimmedLine.find ('"');
+
+      size_t const last = trimmedLine.find ('"', first + 1);
+
+      if (last != string::npos)
+      {
+        includedFiles.push_back ((path (completeName).branch_path ()
+            / trimmedLine.substr (first + 1, last - first - 1)).string ());
+      }
+    }
+  }
+
+  for (vector <string>::iterator it = includedFiles.begin (); it
+      != includedFiles.end (); ++it)
+  {
+    addFileToHash (*it);
+  }
+}
+
+std::string
+TranslationCache::getManifestFileName ()
+{
+  switch (Globals::getInstance ()->getTargetBackend ())
+  {
+    case TargetLanguage::CUDA:
+    {
+      return ".translator.cuda";
+    }
+
+    case TargetLanguage::OPENMP:
+    {
+      return ".translator.openmp";
+    }
+
+    case TargetLanguage::OPENCL:
+    {
+      return ".translator.opencl";
+    }
+
+    default:
+    {
+      throw Exceptions::CommandLine::LanguageException (
+          "Unknown/unsupported backend selected");
+    }
+  }
+}
+
+bool
+TranslationCache::restore ()
+{
+  using boost::filesystem::path;
+  using boost::filesystem::exists;
+  using boost::filesystem::is_regular;
+  using boost::filesystem::remove;
+  using boost::filesystem::copy_file;
+  using boost::filesystem::directory_iterator;
+
+  path const entry (entryDirectory);
+
+  if (exists (entry / getManifestFileName ()) == false)
+  {
+    Debug::getInstance ()->debugMessage ("No cached translation in '"
+        + entryDirectory + "'", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+    return false;
+  }
+
+  Debug::getInstance ()->debugMessage ("Restoring cached translation from '"
+      + entryDirectory + "'", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  for (directory_iterator it (entry); it != directory_iterator (); ++it)
+  {
+    if (is_regular (it->status ()))
+    {
+      path const target (it->path ().leaf ());
+
+      remove (target);
+
+      copy_file (it->path (), target);
+    }
+  }
+
+  return true;
+}
+
+void
+TranslationCache::store ()
+{
+  using boost::filesystem::path;
+  using boost::filesystem::exists;
+  using boost::filesystem::remove;
+  using boost::filesystem::copy_file;
+  using boost::filesystem::create_directories;
+  using boost::starts_with;
+  using boost::split;
+  using boost::is_any_of;
+  using boost::token_compress_on;
+  using std::ifstream;
+  using std::string;
+  using std::vector;
+
+  string const manifestFileName = getManifestFileName ();
+
+  ifstream manifest (manifestFileName.c_str ());
+
+  if (manifest.is_open () == false)
+  {
+    return;
+  }
+
+  Debug::getInstance ()->debugMessage ("Storing translation in '"
+      + entryDirectory + "'", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  path const entry (entryDirectory);
+
+  create_directories (entry);
+
+  string line;
+
+  while (getline (manifest, line))
+  {
+    if (starts_with (line, "files="))
+    {
+      vector <string> fileNames;
+
+      split (fileNames, line.substr (string ("files=").size ()),
+          is_any_of (" "), token_compress_on);
+
+      for (vector <string>::iterator it = fileNames.begin (); it
+          != fileNames.end (); ++it)
+      {
+        if (it->empty () == false && exists (path (*it)))
+        {
+          remove (entry / *it);
+
+          copy_file (path (*it), entry / *it);
+        }
+      }
+    }
+  }
+
+  /*
+   * ======================================================
+   * The manifest is copied last: an entry interrupted
+   * while being stored has no manifest and is never
+   * restored
+   * ======================================================
+   */
+
+  remove (entry / manifestFileName);
+
+  copy_file (path (manifestFileName), entry / manifestFileName);
+}
+
+bool
+TranslationCache::isUsable () const
+{
+  return usable;
+}
+
+TranslationCache::TranslationCache (int argc, char ** argv) :
+  hash (offsetBasis), usable (true)
+{
+  using boost::filesystem::path;
+  using boost::filesystem::exists;
+  using boost::filesystem::is_regular;
+  using boost::filesystem::last_write_time;
+  using boost::lexical_cast;
+  using std::string;
+  using std::ostringstream;
+
+  addToHash (cacheFormat);
+
+  /*
+   * ======================================================
+   * A rebuilt translator may generate different code, so
+   * its modification time is part of the key. Without it a
+   * stale entry could be restored, so the cache is not used
+   * ======================================================
+   */
+
+  string const translator = getExecutablePath (argv[0]);
+
+  if (translator.empty ())
+  {
+    usable = false;
+
+    return;
+  }
+
+  addToHash (lexical_cast <string> (last_write_time (path (translator))));
+
+  /*
+   * ======================================================
+   * Every argument is part of the key: it selects the
+   * backend and options or names an input file. The
+   * contents of arguments naming files, including
+   * configuration files passed to options, are hashed too
+   * ======================================================
+   */
+
+  for (int i = 1; i < argc; ++i)
+  {
+    addToHash (argv[i]);
+
+    path const argument (argv[i]);
+
+    if (exists (argument) && is_regular (argument))
+    {
+      addFileToHash (argv[i]);
+    }
+  }
+
+  ostringstream key;
+
+  key << std::hex << std::setw (16) << std::setfill ('0') << hash;
+
+  entryDirectory = (path (
+      Globals::getInstance ()->getTranslationCacheDirectory ()) / key.str ()).string ();
+}
@@ -0,0 +1,125 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Caches the output of a translation so that a later invocation with
+ * identical input files, included headers, options and translator binary
+ * restores the generated files instead of running the ROSE frontend
+ */
+
+#pragma once
+#ifndef TRANSLATION_CACHE_H
+#define TRANSLATION_CACHE_H
+
+#include <boost/cstdint.hpp>
+#include <set>
+#include <string>
+
+class TranslationCache
+{
+  private:
+
+    /*
+     * ======================================================
+     * Running FNV-1a hash of everything the output of the
+     * translation depends on
+     * ======================================================
+     */
+    boost::uint64_t hash;
+
+    /*
+     * ======================================================
+     * Files already hashed, so that headers included more
+     * than once are only counted once
+     * ======================================================
+     */
+    std::set <std::string> hashedFiles;
+
+    std::string entryDirectory;
+
+    /*
+     * ======================================================
+     * False when the translator executable could not be
+     * found, so that the key cannot depend on its version
+     * ======================================================
+     */
+    bool usable;
+
+  private:
+
+    void
+    addToHash (std::string const & text);
+
+    void
+    addFileToHash (std::string const & fileName);
+
+  public:
+
+    /*
+     * ======================================================
+     * Whether the cache can be used for this run
+     * ======================================================
+     */
+    bool
+    isUsable () const;
+
+    /*
+     * ======================================================
+     * The manifest written after unparsing, which lists the
+     * files generated for the selected backend
+     * ======================================================
+     */
+    static std::string
+    getManifestFileName ();
+
+    /*
+     * ======================================================
+     * Copies the files of a cached translation into the
+     * working directory. Returns false when the cache holds
+     * no translation for these inputs
+     * ======================================================
+     */
+    bool
+    restore ();
+
+    /*
+     * ======================================================
+     * Copies the files listed in the manifest into the cache
+     * ======================================================
+     */
+    void
+    store ();
+
+    TranslationCache (int argc, char ** argv);
+};
+
+#endif
@@ -47,9 +47,17 @@
 #include <iostream>
 #include <fstream>
 #include <rose.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "CPPPreProcess.h"
 #include "CPPSyntacticFusion.h"
+#include "CPPSparseTiling.h"
+#include "LoopDependenceGraph.h"
+#include "OpDatLiveness.h"
+#include "CodeSizeReport.h"
+#include "TranslationCache.h"
+#include "Statistics.h"
 
 template <class TGenerator>
   void
@@ -107,15 +115,41 @@ template <class TGenerator>
 
               file->unparse ();
             }
+            else if (Globals::getInstance ()->eliminateTransfers ())
+            {
+              /*
+               * ======================================================
+               * Fetches may have been removed from files which are not
+               * otherwise modified, so they must be unparsed
+               * ======================================================
+               */
+
+              Debug::getInstance ()->debugMessage ("Unparsing '"
+                  + p.filename () + "'", Debug::FUNCTION_LEVEL, __FILE__,
+                  __LINE__);
+
+              outputFiles.push_back ("rose_" + p.filename ());
+
+              file->unparse ();
+            }
             else
             {
+              /*
+               * ======================================================
+               * The file is untouched, so its output is a copy of the
+               * original source, which is much cheaper than unparsing
+               * ======================================================
+               */
+
               Debug::getInstance ()->debugMessage ("File '" + p.filename ()
                   + "' remains unchanged", Debug::FUNCTION_LEVEL, __FILE__,
                   __LINE__);
 
               outputFiles.push_back ("rose_" + p.filename ());
 
-              file->unparse ();
+              boost::filesystem::remove (path ("rose_" + p.filename ()));
+
+              boost::filesystem::copy_file (p, path ("rose_" + p.filename ()));
             }
           }
         }
@@ -128,37 +162,7 @@ template <class TGenerator>
 
           traverseInputFiles (this->project, preorder);
 
-          string fileName;
-
-          switch (Globals::getInstance ()->getTargetBackend ())
-          {
-            case TargetLanguage::CUDA:
-            {
-              fileName = ".translator.cuda";
-
-              break;
-            }
-
-            case TargetLanguage::OPENMP:
-            {
-              fileName = ".translator.openmp";
-
-              break;
-            }
-
-            case TargetLanguage::OPENCL:
-            {
-              fileName = ".translator.opencl";
-
-              break;
-            }
-
-            default:
-            {
-              throw Exceptions::CommandLine::LanguageException (
-                  "Unknown/unsupported backend selected");
-            }
-          }
+          string const fileName = TranslationCache::getManifestFileName ();
 
           ofstream outputFile;
 
@@ -182,11 +186,40 @@ template <class TGenerator>
         }
     };
 
+    Statistics::getInstance ()->beginPhase ("unparse");
+
     new TreeVisitor (generator, project);
+
+    Statistics::getInstance ()->endPhase ();
   }
 
+CPPProgramDeclarationsAndDefinitions *
+analyseCPPProject (SgProject * project)
+{
+  Statistics::getInstance ()->beginPhase ("declarations");
+
+  CPPProgramDeclarationsAndDefinitions * declarations =
+      new CPPProgramDeclarationsAndDefinitions (project);
+
+  Statistics::getInstance ()->endPhase ();
+
+  if (Globals::getInstance ()->loopGraph ())
+  {
+    new LoopDependenceGraph <CPPProgramDeclarationsAndDefinitions> (
+        declarations);
+  }
+
+  if (Globals::getInstance ()->transferAnalysis ())
+  {
+    new OpDatLiveness <CPPProgramDeclarationsAndDefinitions> (declarations);
+  }
+
+  return declarations;
+}
+
 CPPSubroutinesGeneration *
-handleCPPProject (SgProject * project)
+handleCPPProject (SgProject * project,
+    CPPProgramDeclarationsAndDefinitions * declarations)
 {
   CPPSubroutinesGeneration * generator;
 
@@ -197,11 +230,12 @@ handleCPPProject (SgProject * project)
       Debug::getInstance ()->debugMessage ("CUDA code generation selected",
           Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
-      CPPProgramDeclarationsAndDefinitions * declarations =
-          new CPPProgramDeclarationsAndDefinitions (project);
+      Statistics::getInstance ()->beginPhase ("generation");
 
       generator = new CPPCUDASubroutinesGeneration (project, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
       break;
     }
 
@@ -210,11 +244,12 @@ handleCPPProject (SgProject * project)
       Debug::getInstance ()->debugMessage ("OpenMP code generation selected",
           Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
-      CPPProgramDeclarationsAndDefinitions * declarations =
-          new CPPProgramDeclarationsAndDefinitions (project);
+      Statistics::getInstance ()->beginPhase ("generation");
 
       generator = new CPPOpenMPSubroutinesGeneration (project, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
       break;
     }
 
@@ -223,11 +258,12 @@ handleCPPProject (SgProject * project)
       Debug::getInstance ()->debugMessage ("OpenCL code generation selected",
           Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
-      CPPProgramDeclarationsAndDefinitions * declarations =
-          new CPPProgramDeclarationsAndDefinitions (project);
+      Statistics::getInstance ()->beginPhase ("generation");
 
       generator = new CPPOpenCLSubroutinesGeneration (project, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
       break;
     }
 
@@ -238,11 +274,42 @@ handleCPPProject (SgProject * project)
     }
   }
 
+  if (Globals::getInstance ()->getCodeReportFileName ().empty () == false)
+  {
+    new CodeSizeReport <CPPProgramDeclarationsAndDefinitions> (declarations,
+        generator->getModuleScope ());
+  }
+
   return generator;
 }
 
+FortranProgramDeclarationsAndDefinitions *
+analyseFortranProject (SgProject * project)
+{
+  Statistics::getInstance ()->beginPhase ("declarations");
+
+  FortranProgramDeclarationsAndDefinitions * declarations =
+      new FortranProgramDeclarationsAndDefinitions (project);
+
+  Statistics::getInstance ()->endPhase ();
+
+  if (Globals::getInstance ()->loopGraph ())
+  {
+    new LoopDependenceGraph <FortranProgramDeclarationsAndDefinitions> (
+        declarations);
+  }
+
+  if (Globals::getInstance ()->transferAnalysis ())
+  {
+    new OpDatLiveness <FortranProgramDeclarationsAndDefinitions> (declarations);
+  }
+
+  return declarations;
+}
+
 FortranSubroutinesGeneration *
-handleFortranProject (SgProject * project)
+handleFortranProject (SgProject * project,
+    FortranProgramDeclarationsAndDefinitions * declarations)
 {
   FortranSubroutinesGeneration * generator;
 
@@ -253,11 +320,12 @@ handleFortranProject (SgProject * project)
       Debug::getInstance ()->debugMessage ("CUDA code generation selected",
           Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
-      FortranProgramDeclarationsAndDefinitions * declarations =
-          new FortranProgramDeclarationsAndDefinitions (project);
+      Statistics::getInstance ()->beginPhase ("generation");
 
       generator = new FortranCUDASubroutinesGeneration (project, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
       break;
     }
 
@@ -266,12 +334,13 @@ handleFortranProject (SgProject * project)
       Debug::getInstance ()->debugMessage ("OpenMP code generation selected",
           Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
-      FortranProgramDeclarationsAndDefinitions * declarations =
-          new FortranProgramDeclarationsAndDefinitions (project);
+      Statistics::getInstance ()->beginPhase ("generation");
 
       generator
           = new FortranOpenMPSubroutinesGeneration (project, declarations);
 
+      Statistics::getInstance ()->endPhase ();
+
       break;
     }
 
@@ -282,9 +351,190 @@ handleFortranProject (SgProject * project)
     }
   }
 
+  if (Globals::getInstance ()->getCodeReportFileName ().empty () == false)
+  {
+    new CodeSizeReport <FortranProgramDeclarationsAndDefinitions> (declarations,
+        generator->getModuleScope ());
+  }
+
   return generator;
 }
 
+template <class TDeclarations, class TGenerator>
+  void
+  generateForEachBackend (SgProject * project, TDeclarations * declarations,
+      TGenerator * (*handleProject) (SgProject *, TDeclarations *))
+  {
+    using boost::filesystem::create_directories;
+    using boost::filesystem::path;
+    using std::string;
+    using std::vector;
+
+    if (Globals::getInstance ()->getTargetBackend ()
+        != TargetLanguage::UNKNOWN_BACKEND)
+    {
+      throw Exceptions::CommandLine::MutuallyExclusiveException (
+          "You have selected to generate code for "
+              + TargetLanguage::toString (
+                  Globals::getInstance ()->getTargetBackend ())
+              + " and for a list of backends. These options are mutually exclusive");
+    }
+
+    /*
+     * ======================================================
+     * Code generation modifies the AST, so each backend is
+     * generated in a child process holding a copy-on-write
+     * image of the AST parsed and analysed once here. Each
+     * child writes its files and its manifest into a
+     * directory named after its backend
+     * ======================================================
+     */
+
+    vector <TargetLanguage::BACKEND> const & backends =
+        Globals::getInstance ()->getBatchBackends ();
+
+    vector <pid_t> children;
+
+    std::cout.flush ();
+
+    for (vector <TargetLanguage::BACKEND>::const_iterator it =
+        backends.begin (); it != backends.end (); ++it)
+    {
+      string const directory = TargetLanguage::toString (*it);
+
+      create_directories (path (directory));
+
+      pid_t const child = fork ();
+
+      if (child < 0)
+      {
+        throw Exceptions::CodeGeneration::BackendGenerationException (
+            "Unable to start code generation for " + directory);
+      }
+
+      if (child == 0)
+      {
+        int status = 0;
+
+        try
+        {
+          if (chdir (directory.c_str ()) != 0)
+          {
+            throw Exceptions::CodeGeneration::FileCreationException (
+                "Unable to enter output directory '" + directory + "'");
+          }
+
+          Debug::getInstance ()->debugMessage (directory
+              + " code generation selected", Debug::VERBOSE_LEVEL, __FILE__,
+              __LINE__);
+
+          Globals::getInstance ()->setTargetBackend (*it);
+
+          unparseSourceFiles (project, handleProject (project, declarations));
+        }
+        catch (std::exception const & e)
+        {
+          std::cout << directory << ": " << e.what () << std::endl;
+
+          status = 1;
+        }
+
+        std::cout.flush ();
+
+        _exit (status);
+      }
+
+      children.push_back (child);
+    }
+
+    vector <string> failedBackends;
+
+    for (unsigned int i = 0; i < children.size (); ++i)
+    {
+      int status;
+
+      if (waitpid (children[i], &status, 0) != children[i]
+          || WIFEXITED (status) == false || WEXITSTATUS (status) != 0)
+      {
+        failedBackends.push_back (TargetLanguage::toString (backends[i]));
+      }
+    }
+
+    if (failedBackends.empty () == false)
+    {
+      throw Exceptions::CodeGeneration::BackendGenerationException (
+          "Code generation failed for " + boost::join (failedBackends, ", "));
+    }
+  }
+
+SgProject *
+loadAST ()
+{
+  using boost::filesystem::exists;
+  using boost::filesystem::path;
+  using boost::filesystem::system_complete;
+  using std::string;
+
+  string const & fileName = Globals::getInstance ()->getLoadASTFileName ();
+
+  if (exists (path (fileName)) == false)
+  {
+    throw Exceptions::ASTParsing::NoSourceFileException (
+        "Unable to open AST file '" + fileName + "'");
+  }
+
+  Debug::getInstance ()->debugMessage ("Loading AST from '" + fileName + "'",
+      Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  AST_FILE_IO::clearAllMemoryPools ();
+
+  SgProject * project = isSgProject (AST_FILE_IO::readASTFromFile (fileName));
+
+  /*
+   * ======================================================
+   * The input files were given to the run which saved the
+   * AST, so they are taken from the loaded project
+   * ======================================================
+   */
+
+  SgFilePtrList & files = project->get_fileList ();
+
+  for (SgFilePtrList::iterator it = files.begin (); it != files.end (); ++it)
+  {
+    string const inputFile = system_complete (path (
+        (*it)->getFileName ())).filename ();
+
+    if (Globals::getInstance ()->isInputFile (inputFile) == false)
+    {
+      Globals::getInstance ()->addInputFile (inputFile);
+    }
+  }
+
+  return project;
+}
+
+void
+saveAST (SgProject * project)
+{
+  std::string const & fileName = Globals::getInstance ()->getSaveASTFileName ();
+
+  Debug::getInstance ()->debugMessage ("Saving AST to '" + fileName + "'",
+      Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  AST_FILE_IO::startUp (project);
+
+  AST_FILE_IO::writeASTToFile (fileName);
+
+  /*
+   * ======================================================
+   * Writing the AST invalidates it; it is restored so that
+   * this run can go on to generate code
+   * ======================================================
+   */
+
+  AST_FILE_IO::resetValidAstAfterWriting ();
+}
+
 void
 checkFreeVariablesFileOption ()
 {
@@ -329,6 +579,15 @@ checkBackendOption ()
         "You have not selected a target backend on the command-line. Supported backends are: "
             + backendsString);
   }
+
+  if (Globals::getInstance ()->getPrecisionPolicyFileName ().empty () == false
+      && Globals::getInstance ()->getTargetBackend () != TargetLanguage::CUDA)
+  {
+    throw Exceptions::CommandLine::MutuallyExclusiveException (
+        "You have selected to generate code for " + TargetLanguage::toString (
+            Globals::getInstance ()->getTargetBackend ())
+            + " and given a precision policy, which only CUDA direct loops support. These options are mutually exclusive");
+  }
 }
 
 void
@@ -345,6 +604,54 @@ addCommandLineOptions ()
       new OpenCLOption ("Generate OpenCL code", TargetLanguage::toString (
           TargetLanguage::OPENCL)));
 
+  CommandLine::getInstance ()->addOption (new SaveASTOption (
+      "Save the AST of the parsed program to <file> for later runs",
+      "save-ast"));
+
+  CommandLine::getInstance ()->addOption (new LoadASTOption (
+      "Load the AST saved in <file> instead of parsing the input files",
+      "load-ast"));
+
+  CommandLine::getInstance ()->addOption (new BatchBackendsOption (
+      "Generate code for each backend in the comma-separated <list> from one parse, each into its own directory",
+      "backends"));
+
+  CommandLine::getInstance ()->addOption (new CUDATemplatesOption (
+      "Stage CUDA indirect data through templates specialised by dimension and access",
+      "cuda-templates"));
+
+  CommandLine::getInstance ()->addOption (new CUDARegisterLimitsOption (
+      "File of 'kernel=registers' lines limiting CUDA kernel register usage",
+      "cuda-registers"));
+
+  CommandLine::getInstance ()->addOption (new CUDAAtomicReductionsOption (
+      "Finalise scalar CUDA Fortran reductions on the device with atomics",
+      "cuda-atomic-reductions"));
+
+  CommandLine::getInstance ()->addOption (new CUDACachedGlobalsOption (
+      "Keep read-only CUDA Fortran OP_GBL arrays on the device, uploading them only when they change",
+      "cuda-cache-globals"));
+
+  CommandLine::getInstance ()->addOption (new PrecisionPolicyOption (
+      "File of 'op_dat=float|double' lines giving the precision kernels compute in. CUDA backend and direct loops only; OP_DATs it names must not be passed to indirect loops",
+      "precision-policy"));
+
+  CommandLine::getInstance ()->addOption (new SetSizesOption (
+      "File of 'op_set=size' lines giving OP_SET sizes to specialise code for",
+      "set-sizes"));
+
+  CommandLine::getInstance ()->addOption (new TranslationCacheOption (
+      "Reuse the translation stored in <directory> when inputs and options are unchanged",
+      "translation-cache"));
+
+  CommandLine::getInstance ()->addOption (new StatisticsOption (
+      "Write the wall time, peak memory and AST size of each translation phase to <file> as JSON",
+      "stats"));
+
+  CommandLine::getInstance ()->addOption (new CodeReportOption (
+      "Write the size and resource usage of each generated kernel to <file> as JSON and flag those exceeding device limits",
+      "code-report"));
+
   CommandLine::getInstance ()->addOption (new FreeVariablesModuleOption (
       "The module containing free variables referenced in user kernels"));
 
@@ -355,7 +662,31 @@ addCommandLineOptions ()
       "Preprocess OP2 declarations", "pre"));
 	
   CommandLine::getInstance ()->addOption (new SyntacticFusionOption (
-      "Unsafe OP2 PARLOOP fusion", "sfuse"));
+      "Fuse the named consecutive OP2 PARLOOPs (kernel1:kernel2:...) when legal",
+      "sfuse"));
+
+  CommandLine::getInstance ()->addOption (new AutomaticFusionOption (
+      "Fuse all legal chains of consecutive OP2 PARLOOPs", "fuse"));
+
+  CommandLine::getInstance ()->addOption (new SparseTilingOption (
+      "Sparse tile chains of OP2 PARLOOPs connected through mappings, seeding tiles of the given size. The tiled code accesses OP_DATs on the host, so it must be built with the sequential or OpenMP OP2 libraries, not CUDA or OpenCL",
+      "tile"));
+
+  CommandLine::getInstance ()->addOption (new LoopGraphOption (
+      "Export the OP2 PARLOOP dependence graph to <basename>.dot and <basename>.json",
+      "loop-graph"));
+
+  CommandLine::getInstance ()->addOption (new LoopTimingsOption (
+      "File of op_timing_output lines merged into the exported PARLOOP dependence graph",
+      "loop-timings"));
+
+  CommandLine::getInstance ()->addOption (new EliminateTransfersOption (
+      "Remove fetches of OP_DATs whose host copy is already valid",
+      "eliminate-transfers"));
+
+  CommandLine::getInstance ()->addOption (new TransferReportOption (
+      "File listing the host/device OP_DAT transfers the program still requires",
+      "transfer-report"));
 
   CommandLine::getInstance ()->addUDrawGraphOption ();
 }
@@ -382,12 +713,33 @@ processUserSelections (SgProject * project)
 
       project->unparse ();
     }
-	else if (Globals::getInstance ()->syntacticFusion ())
+	else if (Globals::getInstance ()->syntacticFusion ()
+	    || Globals::getInstance ()->automaticFusion ()
+	    || Globals::getInstance ()->sparseTiling ())
 	{
 	  CPPProgramDeclarationsAndDefinitions * declarations =
 		new CPPProgramDeclarationsAndDefinitions (project);
-		
-	  new CPPSyntacticFusion (project, declarations);
+
+	  if (Globals::getInstance ()->syntacticFusion ()
+	      || Globals::getInstance ()->automaticFusion ())
+	  {
+	    new CPPSyntacticFusion (project, declarations);
+	  }
+
+	  if (Globals::getInstance ()->sparseTiling ())
+	  {
+	    if (Globals::getInstance ()->getTargetBackend () == TargetLanguage::CUDA
+	        || Globals::getInstance ()->getTargetBackend ()
+	            == TargetLanguage::OPENCL)
+	    {
+	      throw Exceptions::CommandLine::MutuallyExclusiveException (
+	          "You have selected to generate code for " + toString (
+	              Globals::getInstance ()->getTargetBackend ())
+	              + " and to sparse tile OP2 PARLOOPs. The tiled code accesses OP_DATs on the host, so these options are mutually exclusive");
+	    }
+
+	    new CPPSparseTiling (project, declarations);
+	  }
 		
 	  project->unparse ();
 	}
@@ -409,11 +761,28 @@ processUserSelections (SgProject * project)
 
       project->unparse ();
     }
+    else if (Globals::getInstance ()->loopGraph ()
+        && Globals::getInstance ()->getTargetBackend ()
+            == TargetLanguage::UNKNOWN_BACKEND
+        && Globals::getInstance ()->getBatchBackends ().empty ())
+    {
+      CPPProgramDeclarationsAndDefinitions * declarations =
+          new CPPProgramDeclarationsAndDefinitions (project);
+
+      new LoopDependenceGraph <CPPProgramDeclarationsAndDefinitions> (
+          declarations);
+    }
+    else if (Globals::getInstance ()->getBatchBackends ().empty () == false)
+    {
+      generateForEachBackend (project, analyseCPPProject (project),
+          handleCPPProject);
+    }
     else
     {
       checkBackendOption ();
 
-      CPPSubroutinesGeneration * generator = handleCPPProject (project);
+      CPPSubroutinesGeneration * generator = handleCPPProject (project,
+          analyseCPPProject (project));
 
       unparseSourceFiles (project, generator);
     }
@@ -425,11 +794,38 @@ processUserSelections (SgProject * project)
 
     Globals::getInstance ()->setHostLanguage (TargetLanguage::FORTRAN);
 
+    if (Globals::getInstance ()->loopGraph ()
+        && Globals::getInstance ()->getTargetBackend ()
+            == TargetLanguage::UNKNOWN_BACKEND
+        && Globals::getInstance ()->getBatchBackends ().empty ())
+    {
+      checkFreeVariablesFileOption ();
+
+      FortranProgramDeclarationsAndDefinitions * declarations =
+          new FortranProgramDeclarationsAndDefinitions (project);
+
+      new LoopDependenceGraph <FortranProgramDeclarationsAndDefinitions> (
+          declarations);
+
+      return;
+    }
+
+    if (Globals::getInstance ()->getBatchBackends ().empty () == false)
+    {
+      checkFreeVariablesFileOption ();
+
+      generateForEachBackend (project, analyseFortranProject (project),
+          handleFortranProject);
+
+      return;
+    }
+
     checkBackendOption ();
 
     checkFreeVariablesFileOption ();
 
-    FortranSubroutinesGeneration * generator = handleFortranProject (project);
+    FortranSubroutinesGeneration * generator = handleFortranProject (project,
+        analyseFortranProject (project));
 
     Debug::getInstance ()->debugMessage ("Fortran project handled, now unparsing..",
       Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
@@ -458,6 +854,40 @@ main (int argc, char ** argv)
 
     CommandLine::getInstance ()->parse (argc, argv);
 
+    /*
+     * ======================================================
+     * The cache holds the generated files only, so runs
+     * which also write analysis reports always translate
+     * ======================================================
+     */
+
+    TranslationCache * cache = NULL;
+
+    if (Globals::getInstance ()->getTranslationCacheDirectory ().empty ()
+        == false && Globals::getInstance ()->getTargetBackend ()
+        != TargetLanguage::UNKNOWN_BACKEND
+        && Globals::getInstance ()->loopGraph () == false
+        && Globals::getInstance ()->getTransferReportFileName ().empty ()
+        && Globals::getInstance ()->getCodeReportFileName ().empty ())
+    {
+      cache = new TranslationCache (argc, argv);
+
+      if (cache->isUsable () == false)
+      {
+        std::cout
+            << "Warning: the translator executable cannot be located, so the translation cache is not used"
+            << std::endl;
+
+        delete cache;
+
+        cache = NULL;
+      }
+      else if (cache->restore ())
+      {
+        return 0;
+      }
+    }
+
     /*
      * ======================================================
      * Pass the pre-processed command-line arguments and NOT
@@ -470,7 +900,25 @@ main (int argc, char ** argv)
 
     CommandLine::getInstance ()->getRoseArguments (args);
 
-    SgProject * project = frontend (args);
+    Statistics::getInstance ()->beginPhase ("frontend");
+
+    SgProject * project;
+
+    if (Globals::getInstance ()->getLoadASTFileName ().empty ())
+    {
+      project = frontend (args);
+    }
+    else
+    {
+      project = loadAST ();
+    }
+
+    Statistics::getInstance ()->endPhase ();
+
+    if (Globals::getInstance ()->getSaveASTFileName ().empty () == false)
+    {
+      saveAST (project);
+    }
 
     ROSE_ASSERT (project != NULL);
 
@@ -478,6 +926,13 @@ main (int argc, char ** argv)
         Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
 
     processUserSelections (project);
+
+    if (cache != NULL)
+    {
+      cache->store ();
+    }
+
+    Statistics::getInstance ()->output ();
   }
   catch (Exceptions::CUDA::GridDimensionException const & e)
   {
@@ -570,6 +1025,12 @@ main (int argc, char ** argv)
 
     return Exceptions::CodeGeneration::FileCreationException::returnValue;
   }
+  catch (Exceptions::CodeGeneration::BackendGenerationException const & e)
+  {
+    std::cout << e.what () << std::endl;
+
+    return Exceptions::CodeGeneration::BackendGenerationException::returnValue;
+  }
   catch (Exceptions::ASTParsing::NoSourceFileException const & e)
   {
     std::cout << e.what () << std::endl;
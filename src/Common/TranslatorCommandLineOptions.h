@@ -33,7 +33,10 @@
 #ifndef TRANSLATOR_COMMAND_LINE_OPTIONS_H
 #define TRANSLATOR_COMMAND_LINE_OPTIONS_H
 
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 #include "Globals.h"
+#include "Exceptions.h"
 #include "TargetLanguage.h"
 #include "CommandLineOption.h"
 #include "CommandLineOptionWithParameters.h"
@@ -102,6 +105,328 @@ public:
 	}
 };
 
+class AutomaticFusionOption: public CommandLineOption
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setAutomaticFusion ();
+    }
+
+    AutomaticFusionOption (std::string helpMessage, std::string longOption) :
+      CommandLineOption (helpMessage, "", longOption)
+    {
+    }
+};
+
+class SparseTilingOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setSparseTileSize (boost::lexical_cast <
+          unsigned int> (getParameter ()));
+    }
+
+    SparseTilingOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "size", "", longOption)
+    {
+    }
+};
+
+class LoopGraphOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setLoopGraphFileName (getParameter ());
+    }
+
+    LoopGraphOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "basename", "", longOption)
+    {
+    }
+};
+
+class LoopTimingsOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setLoopTimingsFileName (getParameter ());
+    }
+
+    LoopTimingsOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class EliminateTransfersOption: public CommandLineOption
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setEliminateTransfers ();
+    }
+
+    EliminateTransfersOption (std::string helpMessage, std::string longOption) :
+      CommandLineOption (helpMessage, "", longOption)
+    {
+    }
+};
+
+class TransferReportOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setTransferReportFileName (getParameter ());
+    }
+
+    TransferReportOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class CUDATemplatesOption: public CommandLineOption
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setGenerateCUDATemplates ();
+    }
+
+    CUDATemplatesOption (std::string helpMessage, std::string longOption) :
+      CommandLineOption (helpMessage, "", longOption)
+    {
+    }
+};
+
+class CUDARegisterLimitsOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setCUDARegisterLimitsFileName (getParameter ());
+    }
+
+    CUDARegisterLimitsOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class CUDACachedGlobalsOption: public CommandLineOption
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setCUDACachedGlobals ();
+    }
+
+    CUDACachedGlobalsOption (std::string helpMessage, std::string longOption) :
+      CommandLineOption (helpMessage, "", longOption)
+    {
+    }
+};
+
+class CUDAAtomicReductionsOption: public CommandLineOption
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setCUDAAtomicReductions ();
+    }
+
+    CUDAAtomicReductionsOption (std::string helpMessage,
+        std::string longOption) :
+      CommandLineOption (helpMessage, "", longOption)
+    {
+    }
+};
+
+class PrecisionPolicyOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setPrecisionPolicyFileName (getParameter ());
+    }
+
+    PrecisionPolicyOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class SetSizesOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setSetSizesFileName (getParameter ());
+    }
+
+    SetSizesOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class TranslationCacheOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setTranslationCacheDirectory (getParameter ());
+    }
+
+    TranslationCacheOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "directory", "",
+          longOption)
+    {
+    }
+};
+
+class StatisticsOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setStatisticsFileName (getParameter ());
+    }
+
+    StatisticsOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class CodeReportOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setCodeReportFileName (getParameter ());
+    }
+
+    CodeReportOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class SaveASTOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setSaveASTFileName (getParameter ());
+    }
+
+    SaveASTOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class LoadASTOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      Globals::getInstance ()->setLoadASTFileName (getParameter ());
+    }
+
+    LoadASTOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "file", "", longOption)
+    {
+    }
+};
+
+class BatchBackendsOption: public CommandLineOptionWithParameters
+{
+  public:
+
+    virtual void
+    run ()
+    {
+      using boost::iequals;
+      using boost::is_any_of;
+      using boost::split;
+      using std::string;
+      using std::vector;
+
+      vector <string> names;
+
+      split (names, getParameter (), is_any_of (","));
+
+      for (vector <string>::iterator it = names.begin (); it != names.end (); ++it)
+      {
+        if (iequals (*it, TargetLanguage::toString (TargetLanguage::CUDA)))
+        {
+          Globals::getInstance ()->addBatchBackend (TargetLanguage::CUDA);
+        }
+        else if (iequals (*it, TargetLanguage::toString (
+            TargetLanguage::OPENMP)))
+        {
+          Globals::getInstance ()->addBatchBackend (TargetLanguage::OPENMP);
+        }
+        else if (iequals (*it, TargetLanguage::toString (
+            TargetLanguage::OPENCL)))
+        {
+          Globals::getInstance ()->addBatchBackend (TargetLanguage::OPENCL);
+        }
+        else
+        {
+          throw Exceptions::CommandLine::LanguageException ("Unknown backend '"
+              + *it + "' in the list of backends to generate");
+        }
+      }
+    }
+
+    BatchBackendsOption (std::string helpMessage, std::string longOption) :
+      CommandLineOptionWithParameters (helpMessage, "list", "", longOption)
+    {
+    }
+};
+
 class CUDAOption: public CommandLineOption
 {
   public:
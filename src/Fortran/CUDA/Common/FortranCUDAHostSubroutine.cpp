@@ -40,6 +40,7 @@
 #include "FortranTypesBuilder.h"
 #include "RoseStatementsAndExpressionsBuilder.h"
 #include "Debug.h"
+#include "Globals.h"
 #include "CompilerGeneratedNames.h"
 #include "OP2.h"
 #include "CUDA.h"
@@ -457,16 +458,26 @@ FortranCUDAHostSubroutine::createReductionPrologueStatements ()
     if (parallelLoop->isReductionRequired (i))
     {
 
+      FortranParallelLoop * fortranParallelLoop =
+          static_cast <FortranParallelLoop *> (parallelLoop);
+
       SgExprStatement * initialiseReductionArraysSize = NULL;
       
       /*
        * ======================================================
+       * Finalised on the device: a single element
        * Direct loops: blocksPerGrid * op_dat dimension
        * Indirect loops: max(plan%nblocks(i)) * op_dat dimension
        * ======================================================
        */
       
-      if ( parallelLoop->isDirectLoop () )
+      if (fortranParallelLoop->isReductionFinalisedOnDevice (i))
+      {
+        initialiseReductionArraysSize = buildAssignStatement (
+          variableDeclarations->getReference (getReductionCardinalityName (i)),
+          buildIntVal (1));
+      }
+      else if ( parallelLoop->isDirectLoop () )
       {
         SgMultiplyOp * multiplyExpression1 = buildMultiplyOp (
           variableDeclarations->getReference (CUDA::blocksPerGrid),
@@ -621,7 +632,11 @@ FortranCUDAHostSubroutine::createReductionPrologueStatements ()
 
         SgExpression * outerUpperBoundExpression = NULL;
         
-        if ( parallelLoop->isDirectLoop () )
+        if (fortranParallelLoop->isReductionFinalisedOnDevice (i))
+        {
+          outerUpperBoundExpression = buildIntVal (0);
+        }
+        else if ( parallelLoop->isDirectLoop () )
         {
           outerUpperBoundExpression = buildSubtractOp (
             variableDeclarations->getReference (CUDA::blocksPerGrid), buildIntVal (1));          
@@ -697,7 +712,60 @@ FortranCUDAHostSubroutine::createReductionEpilogueStatements ()
   {
     if (parallelLoop->isReductionRequired (i))
     {
-      if (parallelLoop->getOpDatDimension (i) == 1)
+      FortranParallelLoop * fortranParallelLoop =
+          static_cast <FortranParallelLoop *> (parallelLoop);
+
+      if (fortranParallelLoop->isReductionFinalisedOnDevice (i))
+      {
+        Debug::getInstance ()->debugMessage (
+            "Creating statements for OP_DAT argument '"
+                + lexical_cast <string> (i) + "' finalised on the device",
+            Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+        /*
+         * ======================================================
+         * The kernel has already combined the results of all
+         * blocks, so only one value is transferred back and
+         * combined with the value held on the host
+         * ======================================================
+         */
+
+        appendStatement (buildAssignStatement (
+            variableDeclarations->getReference (getReductionArrayHostName (i)),
+            variableDeclarations->getReference (
+                getReductionArrayDeviceName (i))), subroutineScope);
+
+        SgPntrArrRefExp * arrayIndexExpression1 = buildPntrArrRefExp (
+            variableDeclarations->getReference (getReductionArrayHostName (i)),
+            buildIntVal (1));
+
+        SgExpression * reductionComputationExpression = NULL;
+
+        if (parallelLoop->isIncremented (i))
+        {
+          reductionComputationExpression = buildAddOp (arrayIndexExpression1,
+              variableDeclarations->getReference (getOpDatHostName (i)));
+        }
+        else
+        {
+          SgFunctionSymbol * functionSymbol =
+              FortranTypesBuilder::buildNewFortranFunction (
+                  parallelLoop->isMaximised (i) ? "max" : "min",
+                  subroutineScope);
+
+          SgExprListExp * actualParameters = buildExprListExp (
+              arrayIndexExpression1, variableDeclarations->getReference (
+                  getOpDatHostName (i)));
+
+          reductionComputationExpression = buildFunctionCallExp (
+              functionSymbol, actualParameters);
+        }
+
+        appendStatement (buildAssignStatement (
+            variableDeclarations->getReference (getOpDatHostName (i)),
+            reductionComputationExpression), subroutineScope);
+      }
+      else if (parallelLoop->getOpDatDimension (i) == 1)
       {
         Debug::getInstance ()->debugMessage (
             "Creating statements for OP_DAT argument '"
@@ -1141,7 +1209,8 @@ FortranCUDAHostSubroutine::createDeallocateStatements ()
     if (parallelLoop->isDuplicateOpDat (i) == false)
     {
       if (parallelLoop->isGlobal (i) && parallelLoop->isArray (i)
-          && parallelLoop->isRead (i))
+          && parallelLoop->isRead (i)
+          && Globals::getInstance ()->useCUDACachedGlobals () == false)
       {
         FortranStatementsAndExpressionsBuilder::appendDeallocateStatement (
             variableDeclarations->getReference (getOpDatDeviceName (i)), block);
@@ -1152,6 +1221,88 @@ FortranCUDAHostSubroutine::createDeallocateStatements ()
   return block;
 }
 
+SgIfStmt *
+FortranCUDAHostSubroutine::createCachedGlobalTransferStatement (
+    unsigned int OP_DAT_ArgumentGroup)
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using namespace OP2VariableNames;
+
+  Debug::getInstance ()->debugMessage (
+      "Creating statements to upload a read-only OP_GBL only when it changes",
+      Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  /*
+   * ======================================================
+   * The device array and the host copy of the values last
+   * uploaded are saved between calls. On the first call
+   * both are allocated and filled; afterwards the values
+   * are uploaded again only if the host copy differs from
+   * the OP_GBL, i.e. if the host has written it. The
+   * dimension of an OP_GBL is fixed by the user kernel, so
+   * the arrays never need to be reallocated
+   * ======================================================
+   */
+
+  SgBasicBlock * firstCallBlock = buildBasicBlock ();
+
+  FortranStatementsAndExpressionsBuilder::appendAllocateStatement (
+      variableDeclarations->getReference (getOpDatDeviceName (
+          OP_DAT_ArgumentGroup)), buildIntVal (1),
+      variableDeclarations->getReference (getOpDatCardinalityName (
+          OP_DAT_ArgumentGroup)), firstCallBlock);
+
+  FortranStatementsAndExpressionsBuilder::appendAllocateStatement (
+      variableDeclarations->getReference (getOpDatCachedName (
+          OP_DAT_ArgumentGroup)), buildIntVal (1),
+      variableDeclarations->getReference (getOpDatCardinalityName (
+          OP_DAT_ArgumentGroup)), firstCallBlock);
+
+  SgBasicBlock * uploadBlock = buildBasicBlock ();
+
+  SgBasicBlock * blocks[] = { firstCallBlock, uploadBlock };
+
+  for (unsigned int j = 0; j < 2; ++j)
+  {
+    appendStatement (buildAssignStatement (variableDeclarations->getReference (
+        getOpDatDeviceName (OP_DAT_ArgumentGroup)),
+        variableDeclarations->getReference (getOpDatHostName (
+            OP_DAT_ArgumentGroup))), blocks[j]);
+
+    appendStatement (buildAssignStatement (variableDeclarations->getReference (
+        getOpDatCachedName (OP_DAT_ArgumentGroup)),
+        variableDeclarations->getReference (getOpDatHostName (
+            OP_DAT_ArgumentGroup))), blocks[j]);
+  }
+
+  SgFunctionCallExp * allocatedExpression = buildFunctionCallExp ("allocated",
+      buildBoolType (), buildExprListExp (variableDeclarations->getReference (
+          getOpDatCachedName (OP_DAT_ArgumentGroup))), subroutineScope);
+
+  SgFunctionCallExp * changedExpression = buildFunctionCallExp ("any",
+      buildBoolType (), buildExprListExp (buildNotEqualOp (
+          variableDeclarations->getReference (getOpDatCachedName (
+              OP_DAT_ArgumentGroup)), variableDeclarations->getReference (
+              getOpDatHostName (OP_DAT_ArgumentGroup)))), subroutineScope);
+
+  SgIfStmt * changedStatement = buildIfStmt (changedExpression, uploadBlock,
+      NULL);
+
+  changedStatement->setCaseInsensitive (true);
+  changedStatement->set_use_then_keyword (true);
+  changedStatement->set_has_end_statement (true);
+
+  SgIfStmt * ifStatement = buildIfStmt (buildNotOp (allocatedExpression),
+      firstCallBlock, buildBasicBlock (changedStatement));
+
+  ifStatement->setCaseInsensitive (true);
+  ifStatement->set_use_then_keyword (true);
+  ifStatement->set_has_end_statement (true);
+
+  return ifStatement;
+}
+
 SgBasicBlock *
 FortranCUDAHostSubroutine::createTransferOpDatStatements ()
 {
@@ -1409,21 +1560,27 @@ FortranCUDAHostSubroutine::createTransferOpDatStatements ()
 
             appendStatement (callStatementA, block);
 
-            SgVarRefExp * arrayExpression = variableDeclarations->getReference (
-                getOpDatDeviceName (i));
-
+            if (Globals::getInstance ()->useCUDACachedGlobals ())
+            {
+              appendStatement (createCachedGlobalTransferStatement (i), block);
+            }
+            else
+            {
+              SgVarRefExp * arrayExpression =
+                  variableDeclarations->getReference (getOpDatDeviceName (i));
 
-            SgVarRefExp * upperBound = variableDeclarations->getReference (
-                getOpDatCardinalityName (i));
+              SgVarRefExp * upperBound = variableDeclarations->getReference (
+                  getOpDatCardinalityName (i));
 
-            FortranStatementsAndExpressionsBuilder::appendAllocateStatement (
-                arrayExpression, buildIntVal (1), upperBound, block);
+              FortranStatementsAndExpressionsBuilder::appendAllocateStatement (
+                  arrayExpression, buildIntVal (1), upperBound, block);
 
-            SgExprStatement * assignmentStatement1 = buildAssignStatement (
-                variableDeclarations->getReference (getOpDatDeviceName (i)),
-                variableDeclarations->getReference (getOpDatHostName (i)));
+              SgExprStatement * assignmentStatement1 = buildAssignStatement (
+                  variableDeclarations->getReference (getOpDatDeviceName (i)),
+                  variableDeclarations->getReference (getOpDatHostName (i)));
 
-            appendStatement (assignmentStatement1, block);
+              appendStatement (assignmentStatement1, block);
+            }
           }
           else
           {
@@ -1526,13 +1683,36 @@ FortranCUDAHostSubroutine::createDataMarshallingDeclarations ()
                 "Creating device array with name " + variableNameOnDevice,
                 Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
 
-            variableDeclarations->add (
-                variableNameOnDevice,
-                FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
-                    variableNameOnDevice,
-                    FortranTypesBuilder::getArray_RankOne (
-                        parallelLoop->getOpDatBaseType (i)), subroutineScope,
-                    2, CUDA_DEVICE, ALLOCATABLE));
+            if (Globals::getInstance ()->useCUDACachedGlobals ())
+            {
+              variableDeclarations->add (
+                  variableNameOnDevice,
+                  FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
+                      variableNameOnDevice,
+                      FortranTypesBuilder::getArray_RankOne (
+                          parallelLoop->getOpDatBaseType (i)),
+                      subroutineScope, 3, CUDA_DEVICE, ALLOCATABLE, SAVE));
+
+              string const & variableNameCached = getOpDatCachedName (i);
+
+              variableDeclarations->add (
+                  variableNameCached,
+                  FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
+                      variableNameCached,
+                      FortranTypesBuilder::getArray_RankOne (
+                          parallelLoop->getOpDatBaseType (i)),
+                      subroutineScope, 2, ALLOCATABLE, SAVE));
+            }
+            else
+            {
+              variableDeclarations->add (
+                  variableNameOnDevice,
+                  FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
+                      variableNameOnDevice,
+                      FortranTypesBuilder::getArray_RankOne (
+                          parallelLoop->getOpDatBaseType (i)),
+                      subroutineScope, 2, CUDA_DEVICE, ALLOCATABLE));
+            }
 
             string const & variableNameOnHost = getOpDatHostName (i);
 
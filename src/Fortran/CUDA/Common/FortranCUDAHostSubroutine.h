@@ -102,6 +102,9 @@ class FortranCUDAHostSubroutine: public FortranHostSubroutine
     getOpDatCardinalityInitialisationExpression (SgScopeStatement * scope,
         unsigned int OP_DAT_ArgumentGroup);
 
+    SgIfStmt *
+    createCachedGlobalTransferStatement (unsigned int OP_DAT_ArgumentGroup);
+
     virtual SgBasicBlock *
     createTransferOpDatStatements ();
 
@@ -285,15 +285,29 @@ FortranCUDAKernelSubroutine::createReductionEpilogueStatements ()
 
         /*
          * ======================================================
-         * Index into the reduction array on the device
+         * Index into the reduction array on the device. When
+         * the reduction is finalised on the device all blocks
+         * fold their result into the first element
          * ======================================================
          */
 
-        SgSubtractOp * subtractExpression = buildSubtractOp (CUDA::getBlockId (
-            BLOCK_X, subroutineScope), buildIntVal (1));
+        FortranParallelLoop * fortranParallelLoop =
+            static_cast <FortranParallelLoop *> (parallelLoop);
+
+        SgExpression * sumExpression;
+
+        if (fortranParallelLoop->isReductionFinalisedOnDevice (i))
+        {
+          sumExpression = buildIntVal (1);
+        }
+        else
+        {
+          SgSubtractOp * subtractExpression = buildSubtractOp (
+              CUDA::getBlockId (BLOCK_X, subroutineScope), buildIntVal (1));
+
+          sumExpression = buildAddOp (subtractExpression, buildIntVal (1));
+        }
 
-        SgAddOp * sumExpression = buildAddOp (subtractExpression, buildIntVal (1));
-            
         SgSubscriptExpression * subscriptExpression = new SgSubscriptExpression (
             RoseHelper::getFileInfo (), sumExpression, buildNullExpression (),
             buildIntVal (1));
@@ -39,6 +39,7 @@
 #include <RoseHelper.h>
 #include <Debug.h>
 #include <CUDA.h>
+#include <Globals.h>
 #include <boost/lexical_cast.hpp>
 
 void
@@ -182,6 +183,70 @@ FortranCUDAReductionSubroutine::createThreadZeroReductionStatements ()
   appendStatement (ifStatement, subroutineScope);
 }
 
+void
+FortranCUDAReductionSubroutine::createThreadZeroAtomicReductionStatements ()
+{
+  using namespace SageBuilder;
+  using namespace SageInterface;
+  using namespace OP2VariableNames;
+  using namespace ReductionVariableNames;
+
+  Debug::getInstance ()->debugMessage (
+      "Creating thread zero atomic reduction statements",
+      Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
+
+  /*
+   * ======================================================
+   * Thread zero folds the block result into the global
+   * result with the atomic matching the reduction type.
+   * Every block then targets the same device location, so
+   * no per-block partial results have to be combined on
+   * the host
+   * ======================================================
+   */
+
+  std::string const atomicFunctionNames[] =
+    { "atomicadd", "atomicmin", "atomicmax" };
+
+  int const reductionTypes[] =
+    { INCREMENT, MINIMUM, MAXIMUM };
+
+  SgBasicBlock * switchBody = buildBasicBlock ();
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    SgFunctionSymbol * atomicFunctionSymbol =
+        FortranTypesBuilder::buildNewFortranFunction (atomicFunctionNames[i],
+            subroutineScope);
+
+    SgExprListExp * actualParameters = buildExprListExp (buildPntrArrRefExp (
+        variableDeclarations->getReference (reductionResult), buildIntVal (1)),
+        buildPntrArrRefExp (variableDeclarations->getReference (
+            sharedVariableName), buildIntVal (0)));
+
+    SgExprStatement * assignmentStatement = buildAssignStatement (
+        variableDeclarations->getReference (reductionPreviousValue),
+        buildFunctionCallExp (atomicFunctionSymbol, actualParameters));
+
+    SgCaseOptionStmt * caseStatement = buildCaseOptionStmt (buildIntVal (
+        reductionTypes[i]), buildBasicBlock (assignmentStatement));
+
+    appendStatement (caseStatement, switchBody);
+  }
+
+  SgSwitchStatement * switchStatement = buildSwitchStatement (
+      variableDeclarations->getReference (reductionOperation), switchBody);
+
+  SgExpression * ifGuardExpression = buildEqualityOp (
+      variableDeclarations->getReference (threadID), buildIntVal (0));
+
+  SgIfStmt * ifStatement =
+      RoseStatementsAndExpressionsBuilder::buildIfStatementWithEmptyElse (
+          ifGuardExpression, buildBasicBlock (switchStatement));
+
+  appendStatement (ifStatement, subroutineScope);
+}
+
 void
 FortranCUDAReductionSubroutine::createReductionStatements ()
 {
@@ -454,7 +519,14 @@ FortranCUDAReductionSubroutine::createStatements ()
       CUDA::createDeviceThreadSynchronisationCallStatement (subroutineScope)),
       subroutineScope);
 
-  createThreadZeroReductionStatements ();
+  if (Globals::getInstance ()->useCUDAAtomicReductions ())
+  {
+    createThreadZeroAtomicReductionStatements ();
+  }
+  else
+  {
+    createThreadZeroReductionStatements ();
+  }
 
   appendStatement (buildExprStatement (
       CUDA::createDeviceThreadSynchronisationCallStatement (subroutineScope)),
@@ -504,6 +576,22 @@ FortranCUDAReductionSubroutine::createLocalVariableDeclarations ()
       threadID,
       FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
           threadID, FortranTypesBuilder::getFourByteInteger (), subroutineScope));
+
+  /*
+   * ======================================================
+   * Receives the value returned by the atomic functions,
+   * which is not otherwise needed
+   * ======================================================
+   */
+
+  if (Globals::getInstance ()->useCUDAAtomicReductions ())
+  {
+    variableDeclarations->add (
+        reductionPreviousValue,
+        FortranStatementsAndExpressionsBuilder::appendVariableDeclaration (
+            reductionPreviousValue, reduction->getBaseType (),
+            subroutineScope));
+  }
 }
 
 void
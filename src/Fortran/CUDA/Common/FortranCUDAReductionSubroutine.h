@@ -63,6 +63,9 @@ class FortranCUDAReductionSubroutine: public Subroutine <
     void
     createThreadZeroReductionStatements ();
 
+    void
+    createThreadZeroAtomicReductionStatements ();
+
     void
     createReductionStatements ();
 
@@ -43,6 +43,7 @@
 #include "FortranCUDAModuleDeclarationsIndirectLoop.h"
 #include "FortranCUDAOpDatCardinalitiesDeclarationIndirectLoop.h"
 #include "FortranOpDatDimensionsDeclaration.h"
+#include "Statistics.h"
 #include <FortranPrintProfilingInformationSubroutine.h>
 #include "FortranParallelLoop.h"
 #include "FortranProgramDeclarationsAndDefinitions.h"
@@ -194,6 +195,8 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
   {
     string const userSubroutineName = it->first;
 
+    Statistics::getInstance ()->beginPhase ("loop " + userSubroutineName);
+
     Debug::getInstance ()->debugMessage ("Analysing user subroutine '"
         + userSubroutineName + "' with subroutines already defined in previous kernels (number = "
         + boost::lexical_cast<string> (allCalledRoutines.size()) + ": ", Debug::FUNCTION_LEVEL, __FILE__, __LINE__);
@@ -208,6 +211,8 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
     FortranParallelLoop * parallelLoop =
         static_cast <FortranParallelLoop *> (it->second);
 
+    Statistics::getInstance ()->beginPhase ("user");
+
     FortranCUDAUserSubroutine * userDeviceSubroutine =
         new FortranCUDAUserSubroutine (moduleScope, parallelLoop, declarations);
 
@@ -248,10 +253,14 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
      */    
     //allCalledRoutines.insert(allCalledRoutines.end(), additionalSubroutines.begin(), additionalSubroutines.end());
     
+    Statistics::getInstance ()->endPhase ();
+
     FortranCUDAKernelSubroutine * kernelSubroutine;
 
     if (parallelLoop->isDirectLoop ())
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine
           = new FortranCUDAKernelSubroutineDirectLoop (
               moduleScope,
@@ -262,6 +271,10 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
               dimensionsDeclarations[userSubroutineName],
               static_cast <FortranCUDAModuleDeclarations *> (moduleDeclarations[userSubroutineName]));
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new FortranCUDAHostSubroutineDirectLoop (
               moduleScope,
@@ -270,9 +283,13 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
               cardinalitiesDeclarations[userSubroutineName],
               dimensionsDeclarations[userSubroutineName],
               static_cast <FortranCUDAModuleDeclarations *> (moduleDeclarations[userSubroutineName]));
+
+      Statistics::getInstance ()->endPhase ();
     }
     else
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine
           = new FortranCUDAKernelSubroutineIndirectLoop (
               moduleScope,
@@ -283,6 +300,10 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
               dimensionsDeclarations[userSubroutineName],
               static_cast <FortranCUDAModuleDeclarations *> (moduleDeclarations[userSubroutineName]));
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new FortranCUDAHostSubroutineIndirectLoop (
               moduleScope,
@@ -291,7 +312,25 @@ FortranCUDASubroutinesGeneration::createSubroutines ()
               static_cast <FortranCUDAOpDatCardinalitiesDeclarationIndirectLoop *> (cardinalitiesDeclarations[userSubroutineName]),
               dimensionsDeclarations[userSubroutineName],
               static_cast <FortranCUDAModuleDeclarations *> (moduleDeclarations[userSubroutineName]));
+
+      Statistics::getInstance ()->endPhase ();
     }
+
+    /*
+     * ======================================================
+     * Only the header statements and names of the generated
+     * subroutines are needed from now on, so the state used
+     * to build them is released before the next loop
+     * ======================================================
+     */
+
+    hostSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    delete userDeviceSubroutine;
+
+    delete kernelSubroutine;
+
+    Statistics::getInstance ()->endPhase ();
   }
 }
 
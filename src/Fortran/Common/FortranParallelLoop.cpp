@@ -31,6 +31,7 @@
 
 
 #include <FortranParallelLoop.h>
+#include <Globals.h>
 #include <rose.h>
 
 bool
@@ -55,6 +56,23 @@ FortranParallelLoop::isCardinalityDeclarationNeeded (
       OP_DAT_ArgumentGroup) && isRead (OP_DAT_ArgumentGroup));
 }
 
+bool
+FortranParallelLoop::isReductionFinalisedOnDevice (
+    unsigned int OP_DAT_ArgumentGroup)
+{
+  /*
+   * ======================================================
+   * Only reductions of dimension one qualify: the block
+   * result is then a single value which thread zero can
+   * fold into the global result with one atomic operation
+   * ======================================================
+   */
+
+  return Globals::getInstance ()->useCUDAAtomicReductions ()
+      && isReductionRequired (OP_DAT_ArgumentGroup) && getOpDatDimension (
+      OP_DAT_ArgumentGroup) == 1;
+}
+
 FortranParallelLoop::FortranParallelLoop (
     SgFunctionCallExp * functionCallExpression) :
   ParallelLoop (functionCallExpression)
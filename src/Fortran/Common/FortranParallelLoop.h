@@ -123,6 +123,16 @@ class FortranParallelLoop: public ParallelLoop
     bool
     isCardinalityDeclarationNeeded (unsigned int OP_DAT_ArgumentGroup);
 
+    /*
+     * ======================================================
+     * Is the reduction on this OP_DAT argument group
+     * completed on the device with atomics, so that a single
+     * value, rather than one per block, returns to the host?
+     * ======================================================
+     */
+    bool
+    isReductionFinalisedOnDevice (unsigned int OP_DAT_ArgumentGroup);
+
     FortranParallelLoop (SgFunctionCallExp * functionCallExpression);
     
     bool
@@ -358,6 +358,8 @@ FortranProgramDeclarationsAndDefinitions::analyseParallelLoopArguments (
             Debug::OUTER_LOOP_LEVEL, __FILE__, __LINE__);
 
         parallelLoop->setOpMapValue (OP_DAT_ArgumentGroup, INDIRECT);
+
+        parallelLoop->setOpMapVariableName (OP_DAT_ArgumentGroup, mappingValue);
       }
            
       /*
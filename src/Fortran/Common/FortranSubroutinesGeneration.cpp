@@ -37,6 +37,7 @@
 #include "FortranProgramDeclarationsAndDefinitions.h"
 #include "FortranReductionSubroutines.h"
 #include "RoseHelper.h"
+#include "Statistics.h"
 #include <boost/algorithm/string/predicate.hpp>
 //#include <tr1_impl/complex>
 
@@ -373,8 +374,12 @@ FortranSubroutinesGeneration::generate ()
 
   addContains ();
 
+  Statistics::getInstance ()->beginPhase ("reductions");
+
   createReductionSubroutines ();
 
+  Statistics::getInstance ()->endPhase ();
+
   createSubroutines ();
 
   patchCallsToParallelLoops (moduleName);
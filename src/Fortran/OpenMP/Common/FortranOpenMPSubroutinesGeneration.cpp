@@ -45,6 +45,7 @@
 #include "Globals.h"
 #include "OpenMP.h"
 #include "OP2.h"
+#include "Statistics.h"
 #include <boost/algorithm/string.hpp>
 
 void
@@ -82,6 +83,8 @@ FortranOpenMPSubroutinesGeneration::createSubroutines ()
   {
     string const userSubroutineName = it->first;
 
+    Statistics::getInstance ()->beginPhase ("loop " + userSubroutineName);
+
     Debug::getInstance ()->debugMessage ("Analysing user subroutine '"
         + userSubroutineName + "' with subroutines already defined in previous kernels, number = "
         + boost::lexical_cast<string> (allCalledRoutines.size()), Debug::FUNCTION_LEVEL, __FILE__, __LINE__);    
@@ -98,6 +101,8 @@ FortranOpenMPSubroutinesGeneration::createSubroutines ()
     Debug::getInstance ()->debugMessage ("Creating userSubroutine object",
       Debug::FUNCTION_LEVEL, __FILE__, __LINE__);            
         
+    Statistics::getInstance ()->beginPhase ("user");
+
     FortranUserSubroutine * userSubroutine = new FortranUserSubroutine (
         moduleScope, parallelLoop, declarations);
 
@@ -143,29 +148,63 @@ FortranOpenMPSubroutinesGeneration::createSubroutines ()
     //        (*it)->getSubroutineHeaderStatement ());
     //    }        
 
+    Statistics::getInstance ()->endPhase ();
+
     FortranOpenMPKernelSubroutine * kernelSubroutine;
 
     if (parallelLoop->isDirectLoop ())
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new FortranOpenMPKernelSubroutineDirectLoop (
           moduleScope, userSubroutine, parallelLoop);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new FortranOpenMPHostSubroutineDirectLoop (moduleScope,
               kernelSubroutine, parallelLoop);
+
+      Statistics::getInstance ()->endPhase ();
     }
     else
     {
+      Statistics::getInstance ()->beginPhase ("kernel");
+
       kernelSubroutine = new FortranOpenMPKernelSubroutineIndirectLoop (
           moduleScope, userSubroutine, parallelLoop);
 
+      Statistics::getInstance ()->endPhase ();
+
+      Statistics::getInstance ()->beginPhase ("host");
+
       hostSubroutines[userSubroutineName]
           = new FortranOpenMPHostSubroutineIndirectLoop (
               moduleScope,
               kernelSubroutine,
               parallelLoop,
               static_cast <FortranOpenMPModuleDeclarationsIndirectLoop *> (moduleDeclarations[userSubroutineName]));
+
+      Statistics::getInstance ()->endPhase ();
     }
+
+    /*
+     * ======================================================
+     * Only the header statements and names of the generated
+     * subroutines are needed from now on, so the state used
+     * to build them is released before the next loop
+     * ======================================================
+     */
+
+    hostSubroutines[userSubroutineName]->releaseBuilderState ();
+
+    delete userSubroutine;
+
+    delete kernelSubroutine;
+
+    Statistics::getInstance ()->endPhase ();
   }
 }
 
@@ -37,12 +37,42 @@
 #include <Exceptions.h>
 #include <rose.h>
 #include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 
 namespace
 {
   std::string const xField = "x";
   std::string const yField = "y";
   std::string const zField = "z";
+
+  std::string const stageInTemplate = "op_cuda_stage_in";
+  std::string const stageOutTemplate = "op_cuda_stage_out";
+  std::string const zeroLocalTemplate = "op_cuda_zero_local";
+  std::string const incrementSharedTemplate = "op_cuda_increment_shared";
+
+  /*
+   * ======================================================
+   * The name of a template instantiation, e.g.
+   * op_cuda_stage_in<4, OP_READ>
+   * ======================================================
+   */
+  std::string
+  getTemplateInstantiationName (std::string const & templateName,
+      unsigned int dimension, std::string const & accessName = "")
+  {
+    using boost::lexical_cast;
+    using boost::to_upper_copy;
+    using std::string;
+
+    string name = templateName + "<" + lexical_cast <string> (dimension);
+
+    if (accessName.empty () == false)
+    {
+      name += ", " + to_upper_copy (accessName);
+    }
+
+    return name + ">";
+  }
 }
 
 SgDotExp *
@@ -315,3 +345,103 @@ CUDA::OP2RuntimeSupport::getPointerToMemoryAllocatedForDeviceReductionArray (
 
   return buildOpaqueVarRefExp ("OP_reduct_d", scope);
 }
+
+std::string
+CUDA::OP2RuntimeSupport::getStageTemplatesSource ()
+{
+  return "\n"
+    "template <int DIM, op_access ACC, typename T>\n"
+    "__device__ void " + stageInTemplate + " (T * shared, T const * dat,\n"
+    "    int const * map, int size)\n"
+    "{\n"
+    "  for (int n = threadIdx.x; n < size * DIM; n += blockDim.x)\n"
+    "  {\n"
+    "    if (ACC == OP_INC)\n"
+    "      shared[n] = (T) 0;\n"
+    "    else\n"
+    "      shared[n] = dat[n % DIM + map[n / DIM] * DIM];\n"
+    "  }\n"
+    "}\n"
+    "\n"
+    "template <int DIM, op_access ACC, typename T>\n"
+    "__device__ void " + stageOutTemplate + " (T * dat, T const * shared,\n"
+    "    int const * map, int size)\n"
+    "{\n"
+    "  for (int n = threadIdx.x; n < size * DIM; n += blockDim.x)\n"
+    "  {\n"
+    "    if (ACC == OP_INC)\n"
+    "      dat[n % DIM + map[n / DIM] * DIM] += shared[n];\n"
+    "    else if (ACC == OP_WRITE || ACC == OP_RW)\n"
+    "      dat[n % DIM + map[n / DIM] * DIM] = shared[n];\n"
+    "  }\n"
+    "}\n"
+    "\n"
+    "template <int DIM, typename T>\n"
+    "__device__ void " + zeroLocalTemplate + " (T * local)\n"
+    "{\n"
+    "  for (int d = 0; d < DIM; ++d)\n"
+    "    local[d] = (T) 0;\n"
+    "}\n"
+    "\n"
+    "template <int DIM, typename T>\n"
+    "__device__ void " + incrementSharedTemplate + " (T * shared, T const * local)\n"
+    "{\n"
+    "  for (int d = 0; d < DIM; ++d)\n"
+    "    shared[d] += local[d];\n"
+    "}\n"
+    "\n";
+}
+
+SgExprStatement *
+CUDA::OP2RuntimeSupport::createStageInCallStatement (SgScopeStatement * scope,
+    unsigned int dimension, std::string const & accessName,
+    SgExpression * sharedMemoryReference, SgExpression * opDatReference,
+    SgExpression * mapReference, SgExpression * sizeReference)
+{
+  using namespace SageBuilder;
+
+  SgExprListExp * actualParameters = buildExprListExp (sharedMemoryReference,
+      opDatReference, mapReference, sizeReference);
+
+  return buildFunctionCallStmt (getTemplateInstantiationName (stageInTemplate,
+      dimension, accessName), buildVoidType (), actualParameters, scope);
+}
+
+SgExprStatement *
+CUDA::OP2RuntimeSupport::createStageOutCallStatement (SgScopeStatement * scope,
+    unsigned int dimension, std::string const & accessName,
+    SgExpression * opDatReference, SgExpression * sharedMemoryReference,
+    SgExpression * mapReference, SgExpression * sizeReference)
+{
+  using namespace SageBuilder;
+
+  SgExprListExp * actualParameters = buildExprListExp (opDatReference,
+      sharedMemoryReference, mapReference, sizeReference);
+
+  return buildFunctionCallStmt (getTemplateInstantiationName (stageOutTemplate,
+      dimension, accessName), buildVoidType (), actualParameters, scope);
+}
+
+SgExprStatement *
+CUDA::OP2RuntimeSupport::createZeroLocalCallStatement (
+    SgScopeStatement * scope, unsigned int dimension,
+    SgExpression * localReference)
+{
+  using namespace SageBuilder;
+
+  return buildFunctionCallStmt (getTemplateInstantiationName (
+      zeroLocalTemplate, dimension), buildVoidType (), buildExprListExp (
+      localReference), scope);
+}
+
+SgExprStatement *
+CUDA::OP2RuntimeSupport::createIncrementSharedCallStatement (
+    SgScopeStatement * scope, unsigned int dimension,
+    SgExpression * sharedMemoryReference, SgExpression * localReference)
+{
+  using namespace SageBuilder;
+
+  return buildFunctionCallStmt (getTemplateInstantiationName (
+      incrementSharedTemplate, dimension), buildVoidType (), buildExprListExp (
+      sharedMemoryReference, localReference), scope);
+}
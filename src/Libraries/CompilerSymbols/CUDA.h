@@ -40,6 +40,8 @@ class SgScopeStatement;
 class SgDotExp;
 class SgFunctionCallExp;
 class SgVarRefExp;
+class SgExpression;
+class SgExprStatement;
 
 enum GRID_DIMENSION
 {
@@ -73,6 +75,25 @@ namespace CUDA
   std::string const threadSynchRet = "threadSynchRet";
   std::string const fortranCplanFunction = "cplan";
 
+  /*
+   * ======================================================
+   * Register file limits of the devices we target, used
+   * to derive launch bounds and to flag kernels whose
+   * occupancy is limited by register pressure
+   * ======================================================
+   */
+  unsigned int const registersPerMultiprocessor = 65536;
+  unsigned int const maximumRegistersPerThread = 255;
+
+  /*
+   * ======================================================
+   * Bytes of kernel parameters and of shared memory a
+   * single thread block may use
+   * ======================================================
+   */
+  unsigned int const maximumParameterBytes = 4096;
+  unsigned int const sharedMemoryPerBlock = 49152;
+
   /*
    * ======================================================
    * Returns an opaque variable reference to either
@@ -205,6 +226,63 @@ namespace CUDA
     SgVarRefExp *
     getPointerToMemoryAllocatedForDeviceReductionArray (
         SgScopeStatement * scope);
+
+    /*
+     * ======================================================
+     * Returns the source of the device templates which stage
+     * indirect OP_DATs in and out of shared memory. The
+     * templates are parameterised by the OP_DAT dimension and
+     * access mode so that nvcc can specialise and unroll them
+     * for each loop
+     * ======================================================
+     */
+    std::string
+    getStageTemplatesSource ();
+
+    /*
+     * ======================================================
+     * Returns a call to the template which stages an indirect
+     * OP_DAT from device memory into shared memory
+     * ======================================================
+     */
+    SgExprStatement *
+    createStageInCallStatement (SgScopeStatement * scope,
+        unsigned int dimension, std::string const & accessName,
+        SgExpression * sharedMemoryReference, SgExpression * opDatReference,
+        SgExpression * mapReference, SgExpression * sizeReference);
+
+    /*
+     * ======================================================
+     * Returns a call to the template which stages an indirect
+     * OP_DAT from shared memory back into device memory
+     * ======================================================
+     */
+    SgExprStatement *
+    createStageOutCallStatement (SgScopeStatement * scope,
+        unsigned int dimension, std::string const & accessName,
+        SgExpression * opDatReference, SgExpression * sharedMemoryReference,
+        SgExpression * mapReference, SgExpression * sizeReference);
+
+    /*
+     * ======================================================
+     * Returns a call to the template which zeroes the local
+     * array of an incremented OP_DAT
+     * ======================================================
+     */
+    SgExprStatement *
+    createZeroLocalCallStatement (SgScopeStatement * scope,
+        unsigned int dimension, SgExpression * localReference);
+
+    /*
+     * ======================================================
+     * Returns a call to the template which adds the local
+     * array of an incremented OP_DAT into shared memory
+     * ======================================================
+     */
+    SgExprStatement *
+    createIncrementSharedCallStatement (SgScopeStatement * scope,
+        unsigned int dimension, SgExpression * sharedMemoryReference,
+        SgExpression * localReference);
   }
 }
 
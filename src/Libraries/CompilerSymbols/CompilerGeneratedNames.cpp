@@ -205,6 +205,15 @@ OP2VariableNames::getOpDatDeviceName (unsigned int OP_DAT_ArgumentGroup)
   return OpDatPrefix + lexical_cast <string> (OP_DAT_ArgumentGroup) + "Device";
 }
 
+std::string const
+OP2VariableNames::getOpDatCachedName (unsigned int OP_DAT_ArgumentGroup)
+{
+  using boost::lexical_cast;
+  using std::string;
+
+  return OpDatPrefix + lexical_cast <string> (OP_DAT_ArgumentGroup) + "Cached";
+}
+
 std::string const
 OP2VariableNames::getOpDatCoreName (unsigned int OP_DAT_ArgumentGroup)
 {
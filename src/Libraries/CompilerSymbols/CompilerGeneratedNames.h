@@ -54,6 +54,7 @@ namespace ReductionVariableNames
   std::string const reductionInput = "inputValue";
   std::string const reductionResult = "reductionResult";
   std::string const reductionOperation = "reductionOperation";
+  std::string const reductionPreviousValue = "reductionPreviousValue";
   std::string const reductionBytes = "reductionBytes";
   std::string const reductionSharedMemorySize = "reductionSharedMemorySize";
 
@@ -245,6 +246,16 @@ namespace OP2VariableNames
   std::string const
   getOpDatDeviceName (unsigned int OP_DAT_ArgumentGroup);
 
+  /*
+   * ======================================================
+   * Returns the name of the host copy of the values last
+   * uploaded for the read-only OP_GBL in this OP_DAT
+   * argument group
+   * ======================================================
+   */
+  std::string const
+  getOpDatCachedName (unsigned int OP_DAT_ArgumentGroup);
+
   /*
    * ======================================================
    * Returns the name of the OP_DAT core variable
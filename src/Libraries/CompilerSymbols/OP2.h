@@ -62,6 +62,7 @@ namespace OP2
   std::string const OP_DECL_MAP = "op_decl_map";
   std::string const OP_DECL_SET = "op_decl_set";\
   std::string const OP_DECL_SUBSET = "op_decl_subset";
+  std::string const OP_EXIT = "op_exit";
   std::string const OP_GBL = "op_gbl";
   std::string const OP_ID = "op_id";
   std::string const OP_INC = "op_inc";
@@ -103,6 +104,16 @@ namespace OP2
     }
   }
 
+  /*
+   * ======================================================
+   * The block size and partition size with which every
+   * generated OP_PAR_LOOP is initialised
+   * ======================================================
+   */
+
+  unsigned int const defaultBlockSize = 512;
+  unsigned int const defaultPartitionSize = 512;
+
   namespace Macros
   {
     /*
@@ -57,6 +57,16 @@ namespace OpenCL
   std::string const commandQueue = "cqCommandQueue";
   std::string const kernelPointer = "kernelPointer";
 
+  /*
+   * ======================================================
+   * The smallest CL_DEVICE_MAX_PARAMETER_SIZE and
+   * CL_DEVICE_LOCAL_MEM_SIZE a full-profile device may
+   * report, so kernels within them run on any device
+   * ======================================================
+   */
+  unsigned int const maximumParameterBytes = 1024;
+  unsigned int const localMemoryPerWorkGroup = 32768;
+
   /*
    * ======================================================
    * The OpenCL type 'cl_kernel'
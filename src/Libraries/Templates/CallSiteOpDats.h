@@ -0,0 +1,112 @@
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ *
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * A parallel loop records the OP_DAT names of its first call site only,
+ * whereas other call sites of the same kernel may pass other OP_DATs.
+ * This recovers the OP_DAT passed in each non-global argument group at a
+ * given call site from its actual arguments, in which the OP_DAT
+ * references appear in argument group order. When the references cannot
+ * be matched to the argument groups, the recorded names are used.
+ *
+ * 1) TDeclarations: the declarations found in the program
+ */
+
+#pragma once
+#ifndef CALL_SITE_OP_DATS_H
+#define CALL_SITE_OP_DATS_H
+
+#include <ParallelLoop.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <rose.h>
+
+template <typename TDeclarations>
+  std::map <unsigned int, std::string>
+  getCallSiteOpDatNames (TDeclarations * declarations,
+      SgFunctionCallExp * functionCallExpression, ParallelLoop * parallelLoop)
+  {
+    using std::map;
+    using std::string;
+    using std::vector;
+
+    vector <string> opDatNames;
+
+    Rose_STL_Container <SgNode *> references = NodeQuery::querySubTree (
+        functionCallExpression->get_args (), V_SgVarRefExp);
+
+    for (Rose_STL_Container <SgNode *>::iterator it = references.begin (); it
+        != references.end (); ++it)
+    {
+      string const name =
+          isSgVarRefExp (*it)->get_symbol ()->get_name ().getString ();
+
+      try
+      {
+        declarations->getOpDatDefinition (name);
+
+        opDatNames.push_back (name);
+      }
+      catch (string const &)
+      {
+      }
+    }
+
+    map <unsigned int, string> names;
+
+    unsigned int position = 0;
+
+    for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+    {
+      if (parallelLoop->isGlobal (i) == false)
+      {
+        names[i] = position < opDatNames.size () ? opDatNames[position]
+            : parallelLoop->getOpDatVariableName (i);
+
+        ++position;
+      }
+    }
+
+    if (position != opDatNames.size ())
+    {
+      for (unsigned int i = 1; i
+          <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+      {
+        if (parallelLoop->isGlobal (i) == false)
+        {
+          names[i] = parallelLoop->getOpDatVariableName (i);
+        }
+      }
+    }
+
+    return names;
+  }
+
+#endif
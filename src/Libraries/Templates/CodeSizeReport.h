@@ -0,0 +1,570 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Reports the size and resource usage of the kernel generated for every
+ * OP_PAR_LOOP once code generation has finished: its parameters and the
+ * bytes they occupy, the local variables and expressions it holds as a
+ * proxy for register pressure, the barriers it executes, the shared
+ * (local) memory each block needs and how its iterations are coloured.
+ *
+ * Shared memory is estimated as the generated host code sizes it: direct
+ * loops stage the largest OP_DAT element of each thread, indirect loops
+ * stage one element of every distinct indirect OP_DAT per iteration of a
+ * partition. The number of colours depends on the mapping values and is
+ * only known once the OP2 run time builds its plan, so the report gives
+ * the levels at which colouring happens.
+ *
+ * Kernels exceeding the parameter or shared memory limits of the selected
+ * backend are flagged, both in the report and on standard output.
+ *
+ * 1) TDeclarations: the declarations found in the program
+ */
+
+#pragma once
+#ifndef CODE_SIZE_REPORT_H
+#define CODE_SIZE_REPORT_H
+
+#include <ParallelLoop.h>
+#include <Globals.h>
+#include <Debug.h>
+#include <OP2.h>
+#include <CUDA.h>
+#include <OpenCL.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <rose.h>
+
+template <typename TDeclarations>
+  class CodeSizeReport
+  {
+    private:
+
+      struct Figures
+      {
+        ParallelLoop * parallelLoop;
+
+        std::string kernelName;
+
+        bool found;
+
+        unsigned int parameters;
+
+        unsigned int parameterBytes;
+
+        unsigned int localVariables;
+
+        unsigned int localBytes;
+
+        unsigned int expressions;
+
+        unsigned int barriers;
+
+        unsigned int barriersInLoops;
+
+        unsigned int sharedBytes;
+
+        std::vector <std::string> warnings;
+      };
+
+      TDeclarations * declarations;
+
+      SgScopeStatement * moduleScope;
+
+      /*
+       * ======================================================
+       * The limits of the selected backend. Zero when the
+       * backend imposes none
+       * ======================================================
+       */
+
+      unsigned int parameterLimit;
+
+      unsigned int sharedMemoryLimit;
+
+      std::vector <Figures> loops;
+
+    private:
+
+      static std::string
+      escape (std::string const & text)
+      {
+        std::string escaped;
+
+        for (std::string::const_iterator it = text.begin (); it != text.end (); ++it)
+        {
+          if (*it == '"' || *it == '\\')
+          {
+            escaped += '\\';
+          }
+          escaped += *it;
+        }
+
+        return escaped;
+      }
+
+      /*
+       * ======================================================
+       * The bytes occupied by a value of the given type.
+       * Pointers, arrays and aggregates are passed as device
+       * addresses
+       * ======================================================
+       */
+      static unsigned int
+      getSizeOfType (SgType * type)
+      {
+        SgType * baseType = type->stripTypedefsAndModifiers ();
+
+        if (isSgTypeChar (baseType) || isSgTypeBool (baseType)
+            || isSgTypeUnsignedChar (baseType))
+        {
+          return 1;
+        }
+        else if (isSgTypeShort (baseType) || isSgTypeUnsignedShort (baseType))
+        {
+          return 2;
+        }
+        else if (isSgTypeInt (baseType) || isSgTypeUnsignedInt (baseType)
+            || isSgTypeFloat (baseType))
+        {
+          return 4;
+        }
+
+        return 8;
+      }
+
+      /*
+       * ======================================================
+       * The bytes occupied by a local variable, counting every
+       * element of a fixed-size array
+       * ======================================================
+       */
+      static unsigned int
+      getSizeOfLocalVariable (SgType * type)
+      {
+        using namespace SageInterface;
+
+        SgArrayType * arrayType = isSgArrayType (
+            type->stripTypedefsAndModifiers ());
+
+        if (arrayType != NULL)
+        {
+          return getArrayElementCount (arrayType) * getSizeOfType (
+              getArrayElementType (arrayType));
+        }
+
+        return getSizeOfType (type);
+      }
+
+      static bool
+      isBarrier (SgFunctionCallExp * functionCallExpression)
+      {
+        SgFunctionSymbol * functionSymbol =
+            functionCallExpression->getAssociatedFunctionSymbol ();
+
+        if (functionSymbol == NULL)
+        {
+          return false;
+        }
+
+        std::string const name = functionSymbol->get_name ().getString ();
+
+        return name == "__syncthreads" || name == "syncthreads" || name
+            == "barrier";
+      }
+
+      static bool
+      isInsideLoop (SgNode * node, SgFunctionDefinition * definition)
+      {
+        for (SgNode * parent = node->get_parent (); parent != NULL && parent
+            != definition; parent = parent->get_parent ())
+        {
+          if (isSgForStatement (parent) || isSgWhileStmt (parent)
+              || isSgDoWhileStmt (parent) || isSgFortranDo (parent))
+          {
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      static bool
+      isSharedMemory (SgVariableDeclaration * variableDeclaration,
+          SgInitializedName * variableName)
+      {
+        SgStorageModifier & storageModifier =
+            variableDeclaration->get_declarationModifier ().get_storageModifier ();
+
+        return storageModifier.isCudaShared ()
+            || storageModifier.isOpenclLocal ()
+            || variableName->get_storageModifier ().isCudaShared ()
+            || variableName->get_storageModifier ().isOpenclLocal ();
+      }
+
+      SgFunctionDeclaration *
+      findKernel (std::string const & kernelName)
+      {
+        Rose_STL_Container <SgNode *> nodes = NodeQuery::querySubTree (
+            moduleScope, V_SgFunctionDeclaration);
+
+        for (Rose_STL_Container <SgNode *>::iterator it = nodes.begin (); it
+            != nodes.end (); ++it)
+        {
+          SgFunctionDeclaration * functionDeclaration =
+              isSgFunctionDeclaration (*it);
+
+          if (functionDeclaration->get_definition () != NULL
+              && functionDeclaration->get_name ().getString () == kernelName)
+          {
+            return functionDeclaration;
+          }
+        }
+
+        return NULL;
+      }
+
+      /*
+       * ======================================================
+       * The shared memory a block needs to stage OP_DAT
+       * elements and, after the loop, to combine reductions
+       * ======================================================
+       */
+      unsigned int
+      getSharedMemoryBytes (ParallelLoop * parallelLoop)
+      {
+        using std::max;
+
+        unsigned int stagingBytes = 0;
+
+        unsigned int reductionBytes = 0;
+
+        for (unsigned int i = 1; i <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+        {
+          if (parallelLoop->isDuplicateOpDat (i) == false)
+          {
+            unsigned int const elementBytes = parallelLoop->getSizeOfOpDat (i)
+                * parallelLoop->getOpDatDimension (i);
+
+            if (parallelLoop->isReductionRequired (i))
+            {
+              reductionBytes = max (reductionBytes, elementBytes
+                  * OP2::defaultBlockSize);
+            }
+            else if (parallelLoop->isDirectLoop ())
+            {
+              if (parallelLoop->isDirect (i))
+              {
+                stagingBytes = max (stagingBytes, elementBytes
+                    * OP2::defaultBlockSize);
+              }
+            }
+            else if (parallelLoop->isIndirect (i))
+            {
+              /*
+               * ======================================================
+               * Every staged array is aligned as by ROUND_UP in the
+               * OP2 run time
+               * ======================================================
+               */
+
+              stagingBytes += (elementBytes * OP2::defaultPartitionSize + 15)
+                  & ~15u;
+            }
+          }
+        }
+
+        return max (stagingBytes, reductionBytes);
+      }
+
+      std::string
+      getColouring (ParallelLoop * parallelLoop)
+      {
+        if (parallelLoop->isDirectLoop ())
+        {
+          return "none";
+        }
+
+        if (parallelLoop->hasIncrementedOpDats ()
+            && Globals::getInstance ()->getTargetBackend ()
+                != TargetLanguage::OPENMP)
+        {
+          return "blocks and threads";
+        }
+
+        return "blocks";
+      }
+
+      void
+      measureKernel (Figures & figures, SgFunctionDeclaration * kernel)
+      {
+        using boost::lexical_cast;
+        using std::string;
+
+        SgInitializedNamePtrList & parameters =
+            kernel->get_parameterList ()->get_args ();
+
+        figures.parameters = parameters.size ();
+
+        for (SgInitializedNamePtrList::iterator it = parameters.begin (); it
+            != parameters.end (); ++it)
+        {
+          figures.parameterBytes += getSizeOfType ((*it)->get_type ());
+        }
+
+        SgFunctionDefinition * definition = kernel->get_definition ();
+
+        Rose_STL_Container <SgNode *> declarations = NodeQuery::querySubTree (
+            definition, V_SgVariableDeclaration);
+
+        for (Rose_STL_Container <SgNode *>::iterator it =
+            declarations.begin (); it != declarations.end (); ++it)
+        {
+          SgVariableDeclaration * variableDeclaration =
+              isSgVariableDeclaration (*it);
+
+          SgInitializedNamePtrList & variables =
+              variableDeclaration->get_variables ();
+
+          for (SgInitializedNamePtrList::iterator variable =
+              variables.begin (); variable != variables.end (); ++variable)
+          {
+            if (isSharedMemory (variableDeclaration, *variable) == false)
+            {
+              figures.localVariables++;
+
+              figures.localBytes += getSizeOfLocalVariable (
+                  (*variable)->get_type ());
+            }
+          }
+        }
+
+        figures.expressions = NodeQuery::querySubTree (definition,
+            V_SgExpression).size ();
+
+        Rose_STL_Container <SgNode *> calls = NodeQuery::querySubTree (
+            definition, V_SgFunctionCallExp);
+
+        for (Rose_STL_Container <SgNode *>::iterator it = calls.begin (); it
+            != calls.end (); ++it)
+        {
+          if (isBarrier (isSgFunctionCallExp (*it)))
+          {
+            figures.barriers++;
+
+            if (isInsideLoop (*it, definition))
+            {
+              figures.barriersInLoops++;
+            }
+          }
+        }
+
+        if (parameterLimit > 0 && figures.parameterBytes > parameterLimit)
+        {
+          figures.warnings.push_back (lexical_cast <string> (
+              figures.parameters) + " parameters occupy "
+              + lexical_cast <string> (figures.parameterBytes)
+              + " bytes, more than the " + lexical_cast <string> (
+              parameterLimit) + " bytes a kernel may be passed");
+        }
+
+        if (Globals::getInstance ()->getTargetBackend () == TargetLanguage::CUDA
+            && figures.localBytes / 4 > CUDA::maximumRegistersPerThread)
+        {
+          figures.warnings.push_back ("local variables occupy "
+              + lexical_cast <string> (figures.localBytes)
+              + " bytes, more than fit in the registers of a thread; expect spilling to local memory");
+        }
+      }
+
+      void
+      measure ()
+      {
+        using boost::lexical_cast;
+        using std::map;
+        using std::string;
+
+        for (map <string, ParallelLoop *>::const_iterator it =
+            declarations->firstParallelLoop (); it
+            != declarations->lastParallelLoop (); ++it)
+        {
+          ParallelLoop * parallelLoop = it->second;
+
+          Figures figures = Figures ();
+
+          figures.parallelLoop = parallelLoop;
+
+          figures.kernelName = parallelLoop->getUserSubroutineName ()
+              + "_kernel";
+
+          if (Globals::getInstance ()->getTargetBackend ()
+              != TargetLanguage::OPENMP)
+          {
+            figures.sharedBytes = getSharedMemoryBytes (parallelLoop);
+
+            if (sharedMemoryLimit > 0 && figures.sharedBytes
+                > sharedMemoryLimit)
+            {
+              figures.warnings.push_back ("each block needs "
+                  + lexical_cast <string> (figures.sharedBytes)
+                  + " bytes of shared memory, more than the "
+                  + lexical_cast <string> (sharedMemoryLimit)
+                  + " bytes available");
+            }
+          }
+
+          SgFunctionDeclaration * kernel = findKernel (figures.kernelName);
+
+          figures.found = kernel != NULL;
+
+          if (kernel != NULL)
+          {
+            measureKernel (figures, kernel);
+          }
+          else
+          {
+            Debug::getInstance ()->debugMessage ("Kernel '"
+                + figures.kernelName + "' not found in the generated code",
+                Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+          }
+
+          for (std::vector <string>::const_iterator warning =
+              figures.warnings.begin (); warning != figures.warnings.end (); ++warning)
+          {
+            std::cout << "Warning: kernel '" << figures.kernelName << "': "
+                << *warning << std::endl;
+          }
+
+          loops.push_back (figures);
+        }
+      }
+
+      void
+      writeJSON (std::string const & fileName)
+      {
+        using std::ofstream;
+
+        ofstream outputFile (fileName.c_str ());
+
+        outputFile << "{\n  \"backend\": \"" << TargetLanguage::toString (
+            Globals::getInstance ()->getTargetBackend ())
+            << "\",\n  \"blockSize\": " << OP2::defaultBlockSize
+            << ",\n  \"partitionSize\": " << OP2::defaultPartitionSize
+            << ",\n  \"parameterLimit\": " << parameterLimit
+            << ",\n  \"sharedMemoryLimit\": " << sharedMemoryLimit
+            << ",\n  \"loops\": [";
+
+        for (unsigned int loop = 0; loop < loops.size (); ++loop)
+        {
+          Figures const & figures = loops[loop];
+
+          outputFile << (loop == 0 ? "\n" : ",\n") << "    {\"kernel\": \""
+              << escape (figures.kernelName) << "\", \"direct\": "
+              << (figures.parallelLoop->isDirectLoop () ? "true" : "false")
+              << ", \"arguments\": "
+              << figures.parallelLoop->getNumberOfOpDatArgumentGroups ()
+              << ", \"found\": " << (figures.found ? "true" : "false")
+              << ", \"parameters\": " << figures.parameters
+              << ", \"parameterBytes\": " << figures.parameterBytes
+              << ", \"localVariables\": " << figures.localVariables
+              << ", \"localBytes\": " << figures.localBytes
+              << ", \"expressions\": " << figures.expressions
+              << ", \"barriers\": " << figures.barriers
+              << ", \"barriersInLoops\": " << figures.barriersInLoops
+              << ", \"sharedBytesPerBlock\": " << figures.sharedBytes
+              << ", \"colouring\": \"" << getColouring (figures.parallelLoop)
+              << "\", \"warnings\": [";
+
+          for (unsigned int i = 0; i < figures.warnings.size (); ++i)
+          {
+            outputFile << (i == 0 ? "\"" : ", \"") << escape (
+                figures.warnings[i]) << "\"";
+          }
+
+          outputFile << "]}";
+        }
+
+        outputFile << "\n  ]\n}\n";
+      }
+
+    public:
+
+      CodeSizeReport (TDeclarations * declarations,
+          SgScopeStatement * moduleScope) :
+        declarations (declarations), moduleScope (moduleScope),
+            parameterLimit (0), sharedMemoryLimit (0)
+      {
+        std::string const & fileName =
+            Globals::getInstance ()->getCodeReportFileName ();
+
+        Debug::getInstance ()->debugMessage (
+            "Reporting generated code size to '" + fileName + "'",
+            Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+        switch (Globals::getInstance ()->getTargetBackend ())
+        {
+          case TargetLanguage::CUDA:
+          {
+            parameterLimit = CUDA::maximumParameterBytes;
+
+            sharedMemoryLimit = CUDA::sharedMemoryPerBlock;
+
+            break;
+          }
+
+          case TargetLanguage::OPENCL:
+          {
+            parameterLimit = OpenCL::maximumParameterBytes;
+
+            sharedMemoryLimit = OpenCL::localMemoryPerWorkGroup;
+
+            break;
+          }
+
+          default:
+          {
+            break;
+          }
+        }
+
+        measure ();
+
+        writeJSON (fileName);
+      }
+  };
+
+#endif
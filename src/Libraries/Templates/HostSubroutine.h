@@ -91,6 +91,23 @@ template <typename TSubroutineHeader>
             parallelLoop)
       {
       }
+
+    public:
+
+      /*
+       * ======================================================
+       * The kernel is not called through this subroutine once
+       * it has been built, so it may be deleted afterwards
+       * ======================================================
+       */
+
+      virtual void
+      releaseBuilderState ()
+      {
+        Subroutine <TSubroutineHeader>::releaseBuilderState ();
+
+        calleeSubroutine = NULL;
+      }
   };
 
 #endif
@@ -0,0 +1,595 @@
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ *
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Exports the dependence graph between the OP_PAR_LOOP calls of the
+ * program under analysis. Every call is a node; every pair of calls
+ * ordered through an OP_DAT is an edge labelled with the OP_DAT, the
+ * access mode of the later call, the arity of the mapping through which
+ * it is accessed and the bytes it holds per set element. Runtime timings
+ * printed by op_timing_output can be merged into the nodes.
+ *
+ * The graph is written in DOT and JSON formats. Calls are ordered by their
+ * position in the source files, which approximates program order when
+ * loops are not spread over several files
+ *
+ * 1) TDeclarations: the declarations found in the program
+ */
+
+#pragma once
+#ifndef LOOP_DEPENDENCE_GRAPH_H
+#define LOOP_DEPENDENCE_GRAPH_H
+
+#include <ParallelLoop.h>
+#include <CallSiteOpDats.h>
+#include <OP2Definitions.h>
+#include <Globals.h>
+#include <Debug.h>
+#include <Exceptions.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <rose.h>
+
+template <typename TDeclarations>
+  class LoopDependenceGraph
+  {
+    private:
+
+      enum DEPENDENCE
+      {
+        FLOW, ANTI, OUTPUT
+      };
+
+      struct Node
+      {
+        ParallelLoop * parallelLoop;
+
+        SgFunctionCallExp * functionCallExpression;
+
+        std::string fileName;
+
+        int line;
+      };
+
+      struct Edge
+      {
+        unsigned int source;
+
+        unsigned int destination;
+
+        DEPENDENCE dependence;
+
+        std::string opDatName;
+
+        unsigned int OP_DAT_ArgumentGroup;
+      };
+
+      struct Timing
+      {
+        unsigned int count;
+
+        double time;
+      };
+
+      struct NodeOrder
+      {
+        bool
+        operator() (Node const & first, Node const & second) const
+        {
+          if (first.fileName != second.fileName)
+          {
+            return first.fileName < second.fileName;
+          }
+
+          return first.line < second.line;
+        }
+      };
+
+    private:
+
+      TDeclarations * declarations;
+
+      std::vector <Node> nodes;
+
+      std::vector <Edge> edges;
+
+      /*
+       * ======================================================
+       * OP_kernels timings, indexed by kernel name
+       * ======================================================
+       */
+      std::map <std::string, Timing> timings;
+
+    private:
+
+      static std::string
+      toString (DEPENDENCE dependence)
+      {
+        switch (dependence)
+        {
+          case FLOW:
+            return "flow";
+          case ANTI:
+            return "anti";
+          default:
+            return "output";
+        }
+      }
+
+      static std::string
+      getAccessMode (ParallelLoop * parallelLoop,
+          unsigned int OP_DAT_ArgumentGroup)
+      {
+        if (parallelLoop->isRead (OP_DAT_ArgumentGroup))
+        {
+          return "OP_READ";
+        }
+        else if (parallelLoop->isWritten (OP_DAT_ArgumentGroup))
+        {
+          return "OP_WRITE";
+        }
+        else if (parallelLoop->isReadAndWritten (OP_DAT_ArgumentGroup))
+        {
+          return "OP_RW";
+        }
+        else if (parallelLoop->isIncremented (OP_DAT_ArgumentGroup))
+        {
+          return "OP_INC";
+        }
+        return "OP_MIN/OP_MAX";
+      }
+
+      static std::string
+      escape (std::string const & text)
+      {
+        std::string escaped;
+
+        for (std::string::const_iterator it = text.begin (); it != text.end (); ++it)
+        {
+          if (*it == '"' || *it == '\\')
+          {
+            escaped += '\\';
+          }
+          escaped += *it;
+        }
+
+        return escaped;
+      }
+
+      /*
+       * ======================================================
+       * The number of elements of the OP_DAT touched per
+       * iteration: the dimension of the mapping for indirect
+       * arguments, one otherwise
+       * ======================================================
+       */
+      unsigned int
+      getArity (ParallelLoop * parallelLoop, unsigned int OP_DAT_ArgumentGroup)
+      {
+        if (parallelLoop->isIndirect (OP_DAT_ArgumentGroup) == false)
+        {
+          return 1;
+        }
+
+        try
+        {
+          return declarations->getOpMapDefinition (
+              parallelLoop->getOpMapVariableName (OP_DAT_ArgumentGroup))->getDimension ();
+        }
+        catch (std::string const &)
+        {
+          return 1;
+        }
+      }
+
+      unsigned int
+      getBytesPerElement (ParallelLoop * parallelLoop,
+          unsigned int OP_DAT_ArgumentGroup)
+      {
+        return parallelLoop->getSizeOfOpDat (OP_DAT_ArgumentGroup)
+            * parallelLoop->getOpDatDimension (OP_DAT_ArgumentGroup);
+      }
+
+      /*
+       * ======================================================
+       * Upper bound on the bytes moved per iteration of the
+       * loop, ignoring reuse through the mappings
+       * ======================================================
+       */
+      unsigned int
+      getBytesPerIteration (ParallelLoop * parallelLoop)
+      {
+        unsigned int bytes = 0;
+
+        for (unsigned int i = 1; i
+            <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+        {
+          if (parallelLoop->isGlobal (i) == false)
+          {
+            bytes += getArity (parallelLoop, i) * getBytesPerElement (
+                parallelLoop, i);
+          }
+        }
+
+        return bytes;
+      }
+
+      void
+      readTimings ()
+      {
+        using boost::lexical_cast;
+        using boost::bad_lexical_cast;
+        using boost::split;
+        using boost::trim_copy;
+        using boost::is_any_of;
+        using boost::token_compress_on;
+        using std::ifstream;
+        using std::string;
+        using std::vector;
+
+        /*
+         * ======================================================
+         * Each line printed by op_timing_output has the form
+         * '<count> <time> [<GB/s>] [<GB/s>] <kernel>'; any
+         * other line is ignored
+         * ======================================================
+         */
+
+        string const & fileName =
+            Globals::getInstance ()->getLoopTimingsFileName ();
+
+        if (fileName.empty ())
+        {
+          return;
+        }
+
+        ifstream inputFile (fileName.c_str ());
+
+        if (inputFile.is_open () == false)
+        {
+          throw Exceptions::ASTParsing::NoSourceFileException (
+              "Unable to open OP_PAR_LOOP timings file '" + fileName + "'");
+        }
+
+        string line;
+
+        while (getline (inputFile, line))
+        {
+          line = trim_copy (line);
+
+          vector <string> fields;
+
+          split (fields, line, is_any_of (" \t"), token_compress_on);
+
+          if (fields.size () < 3)
+          {
+            continue;
+          }
+
+          try
+          {
+            Timing timing;
+
+            timing.count = lexical_cast <unsigned int> (fields[0]);
+
+            timing.time = lexical_cast <double> (fields[1]);
+
+            timings[fields.back ()] = timing;
+          }
+          catch (bad_lexical_cast const &)
+          {
+          }
+        }
+      }
+
+      void
+      addNodes ()
+      {
+        using std::map;
+        using std::string;
+        using std::vector;
+
+        for (typename map <string, ParallelLoop *>::const_iterator it =
+            declarations->firstParallelLoop (); it
+            != declarations->lastParallelLoop (); ++it)
+        {
+          ParallelLoop * parallelLoop = it->second;
+
+          for (vector <SgFunctionCallExp *>::const_iterator callIt =
+              parallelLoop->getFirstFunctionCall (); callIt
+              != parallelLoop->getLastFunctionCall (); ++callIt)
+          {
+            Node node;
+
+            node.parallelLoop = parallelLoop;
+
+            node.functionCallExpression = *callIt;
+
+            node.fileName
+                = (*callIt)->get_file_info ()->get_filenameString ();
+
+            node.line = (*callIt)->get_file_info ()->get_line ();
+
+            nodes.push_back (node);
+          }
+        }
+
+        std::stable_sort (nodes.begin (), nodes.end (), NodeOrder ());
+      }
+
+      void
+      addEdge (unsigned int source, unsigned int destination,
+          DEPENDENCE dependence, std::string const & opDatName,
+          unsigned int OP_DAT_ArgumentGroup)
+      {
+        Edge edge;
+
+        edge.source = source;
+
+        edge.destination = destination;
+
+        edge.dependence = dependence;
+
+        edge.opDatName = opDatName;
+
+        edge.OP_DAT_ArgumentGroup = OP_DAT_ArgumentGroup;
+
+        edges.push_back (edge);
+      }
+
+      /*
+       * ======================================================
+       * Walks the calls in order, remembering the last writer
+       * and the readers since then of every OP_DAT
+       * ======================================================
+       */
+      void
+      addEdges ()
+      {
+        using std::map;
+        using std::set;
+        using std::string;
+
+        map <string, unsigned int> lastWriter;
+
+        map <string, set <unsigned int> > readersSinceWrite;
+
+        for (unsigned int node = 0; node < nodes.size (); ++node)
+        {
+          ParallelLoop * parallelLoop = nodes[node].parallelLoop;
+
+          map <unsigned int, string> opDatNames = getCallSiteOpDatNames (
+              declarations, nodes[node].functionCallExpression, parallelLoop);
+
+          for (unsigned int i = 1; i
+              <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+          {
+            if (parallelLoop->isGlobal (i) || parallelLoop->isDuplicateOpDat (i))
+            {
+              continue;
+            }
+
+            string const opDatName = opDatNames[i];
+
+            bool const reads = parallelLoop->isWritten (i) == false;
+
+            bool const writes = parallelLoop->isRead (i) == false;
+
+            if (reads && lastWriter.count (opDatName) > 0)
+            {
+              addEdge (lastWriter[opDatName], node, FLOW, opDatName, i);
+            }
+
+            if (writes)
+            {
+              set <unsigned int> & readers = readersSinceWrite[opDatName];
+
+              for (set <unsigned int>::const_iterator it = readers.begin (); it
+                  != readers.end (); ++it)
+              {
+                if (*it != node)
+                {
+                  addEdge (*it, node, ANTI, opDatName, i);
+                }
+              }
+
+              if (readers.empty () && reads == false && lastWriter.count (
+                  opDatName) > 0)
+              {
+                addEdge (lastWriter[opDatName], node, OUTPUT, opDatName, i);
+              }
+
+              readers.clear ();
+
+              lastWriter[opDatName] = node;
+            }
+            else
+            {
+              readersSinceWrite[opDatName].insert (node);
+            }
+          }
+        }
+      }
+
+      std::string
+      getNodeName (unsigned int node)
+      {
+        return "loop" + boost::lexical_cast <std::string> (node);
+      }
+
+      void
+      writeDOT (std::string const & fileName)
+      {
+        using boost::lexical_cast;
+        using std::ofstream;
+        using std::string;
+
+        ofstream outputFile (fileName.c_str ());
+
+        outputFile << "digraph loops\n{\n  node [shape=box];\n";
+
+        for (unsigned int node = 0; node < nodes.size (); ++node)
+        {
+          ParallelLoop * parallelLoop = nodes[node].parallelLoop;
+
+          string const kernelName = parallelLoop->getUserSubroutineName ();
+
+          string label = kernelName + "\\n" + nodes[node].fileName + ":"
+              + lexical_cast <string> (nodes[node].line) + "\\n"
+              + lexical_cast <string> (getBytesPerIteration (parallelLoop))
+              + " bytes/iteration";
+
+          if (timings.count (kernelName) > 0)
+          {
+            label += "\\n" + lexical_cast <string> (timings[kernelName].count)
+                + " calls, " + lexical_cast <string> (timings[kernelName].time)
+                + " s";
+          }
+
+          outputFile << "  " << getNodeName (node) << " [label=\"" << escape (
+              label) << "\"];\n";
+        }
+
+        for (typename std::vector <Edge>::const_iterator it = edges.begin (); it
+            != edges.end (); ++it)
+        {
+          ParallelLoop * parallelLoop = nodes[it->destination].parallelLoop;
+
+          string const label = it->opDatName + " " + getAccessMode (
+              parallelLoop, it->OP_DAT_ArgumentGroup) + "\\narity "
+              + lexical_cast <string> (getArity (parallelLoop,
+                  it->OP_DAT_ArgumentGroup)) + ", "
+              + lexical_cast <string> (getBytesPerElement (parallelLoop,
+                  it->OP_DAT_ArgumentGroup)) + " bytes/element";
+
+          outputFile << "  " << getNodeName (it->source) << " -> "
+              << getNodeName (it->destination) << " [label=\"" << escape (
+              label) << "\"";
+
+          if (it->dependence != FLOW)
+          {
+            outputFile << ", style=dashed";
+          }
+
+          outputFile << "];\n";
+        }
+
+        outputFile << "}\n";
+      }
+
+      void
+      writeJSON (std::string const & fileName)
+      {
+        using std::ofstream;
+
+        ofstream outputFile (fileName.c_str ());
+
+        outputFile << "{\n  \"loops\": [";
+
+        for (unsigned int node = 0; node < nodes.size (); ++node)
+        {
+          ParallelLoop * parallelLoop = nodes[node].parallelLoop;
+
+          std::string const kernelName = parallelLoop->getUserSubroutineName ();
+
+          outputFile << (node == 0 ? "\n" : ",\n") << "    {\"id\": \""
+              << getNodeName (node) << "\", \"kernel\": \"" << escape (
+              kernelName) << "\", \"file\": \"" << escape (
+              nodes[node].fileName) << "\", \"line\": " << nodes[node].line
+              << ", \"direct\": " << (parallelLoop->isDirectLoop () ? "true"
+              : "false") << ", \"bytesPerIteration\": "
+              << getBytesPerIteration (parallelLoop);
+
+          if (timings.count (kernelName) > 0)
+          {
+            outputFile << ", \"count\": " << timings[kernelName].count
+                << ", \"time\": " << timings[kernelName].time;
+          }
+
+          outputFile << "}";
+        }
+
+        outputFile << "\n  ],\n  \"dependences\": [";
+
+        for (unsigned int edge = 0; edge < edges.size (); ++edge)
+        {
+          Edge const & dependence = edges[edge];
+
+          ParallelLoop * parallelLoop =
+              nodes[dependence.destination].parallelLoop;
+
+          unsigned int const i = dependence.OP_DAT_ArgumentGroup;
+
+          outputFile << (edge == 0 ? "\n" : ",\n") << "    {\"source\": \""
+              << getNodeName (dependence.source)
+              << "\", \"destination\": \"" << getNodeName (
+              dependence.destination) << "\", \"kind\": \"" << toString (
+              dependence.dependence) << "\", \"dat\": \"" << escape (
+              dependence.opDatName) << "\", \"access\": \"" << getAccessMode (
+              parallelLoop, i) << "\", \"map\": \"" << escape (
+              parallelLoop->getOpMapVariableName (i)) << "\", \"arity\": "
+              << getArity (parallelLoop, i) << ", \"bytesPerElement\": "
+              << getBytesPerElement (parallelLoop, i) << "}";
+        }
+
+        outputFile << "\n  ]\n}\n";
+      }
+
+    public:
+
+      LoopDependenceGraph (TDeclarations * declarations) :
+        declarations (declarations)
+      {
+        std::string const & baseName =
+            Globals::getInstance ()->getLoopGraphFileName ();
+
+        Debug::getInstance ()->debugMessage (
+            "Exporting OP_PAR_LOOP dependence graph to '" + baseName + "'",
+            Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+        readTimings ();
+
+        addNodes ();
+
+        addEdges ();
+
+        writeDOT (baseName + ".dot");
+
+        writeJSON (baseName + ".json");
+      }
+  };
+
+#endif
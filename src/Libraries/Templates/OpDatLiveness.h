@@ -0,0 +1,580 @@
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ *
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Computes, at every point of each function calling OP_PAR_LOOPs, which
+ * OP_DATs hold a valid copy on the host. A copy becomes valid when it is
+ * fetched from the device and stops being valid when an OP_PAR_LOOP
+ * writes the OP_DAT, or when the host writes memory or calls a function
+ * that may do either. A fetch of an OP_DAT whose host copy is valid is a
+ * redundant device-to-host transfer and can be removed.
+ *
+ * Branches meet by intersection; loop bodies are entered with the OP_DATs
+ * they may invalidate already invalidated, so the result holds for every
+ * iteration. Calls are followed through functions defined in the input;
+ * other functions are assumed to write host data, apart from the OP2 API
+ * and a few library functions such as printf.
+ *
+ * 1) TDeclarations: the declarations found in the program
+ */
+
+#pragma once
+#ifndef OP_DAT_LIVENESS_H
+#define OP_DAT_LIVENESS_H
+
+#include <ParallelLoop.h>
+#include <CallSiteOpDats.h>
+#include <Globals.h>
+#include <Debug.h>
+#include <Exceptions.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <rose.h>
+
+template <typename TDeclarations>
+  class OpDatLiveness
+  {
+    private:
+
+      typedef std::set <std::string> State;
+
+    private:
+
+      TDeclarations * declarations;
+
+      /*
+       * ======================================================
+       * Every OP_PAR_LOOP call in the program, mapped to the
+       * parallel loop it invokes
+       * ======================================================
+       */
+      std::map <SgFunctionCallExp *, ParallelLoop *> parallelLoopCalls;
+
+      /*
+       * ======================================================
+       * Whether a function defined in the input may write an
+       * OP_DAT on the device or memory on the host
+       * ======================================================
+       */
+      std::map <SgFunctionDeclaration *, bool> sideEffects;
+
+      /*
+       * ======================================================
+       * Fetches found to transfer data already on the host
+       * ======================================================
+       */
+      std::vector <SgStatement *> redundantFetches;
+
+      std::vector <std::string> report;
+
+    private:
+
+      static bool
+      isFetchCall (SgFunctionCallExp * functionCallExpression)
+      {
+        using boost::iequals;
+
+        SgFunctionRefExp * functionReference = isSgFunctionRefExp (
+            functionCallExpression->get_function ());
+
+        if (functionReference == NULL)
+        {
+          return false;
+        }
+
+        std::string const functionName =
+            functionReference->getAssociatedFunctionDeclaration ()->get_name ().getString ();
+
+        return iequals (functionName, "op_fetch_data") || iequals (
+            functionName, "op_fetchdata") || iequals (functionName,
+            "op_get_dat");
+      }
+
+      /*
+       * ======================================================
+       * Functions without a definition in the input are assumed
+       * to write host data, except the OP2 API and the library
+       * functions listed here, which cannot reach the data of
+       * an OP_DAT
+       * ======================================================
+       */
+      static bool
+      isHarmlessExternalFunction (std::string const & functionName)
+      {
+        using boost::iequals;
+        using boost::istarts_with;
+
+        static char const * const harmlessFunctions[] =
+        { "printf", "fprintf", "puts", "putchar", "fflush", "sqrt", "fabs",
+            "abs", "pow", "exp", "log", "sin", "cos", "tan", "atan", "atan2",
+            "floor", "ceil", "min", "max" };
+
+        if (istarts_with (functionName, "op_"))
+        {
+          return true;
+        }
+
+        for (unsigned int i = 0; i < sizeof (harmlessFunctions)
+            / sizeof (harmlessFunctions[0]); ++i)
+        {
+          if (iequals (functionName, harmlessFunctions[i]))
+          {
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      static bool
+      isHostWrite (SgNode * node)
+      {
+        SgExpression * writtenExpression = NULL;
+
+        if (isSgAssignOp (node) || isSgCompoundAssignOp (node))
+        {
+          writtenExpression = isSgBinaryOp (node)->get_lhs_operand ();
+        }
+        else if (isSgPlusPlusOp (node) || isSgMinusMinusOp (node))
+        {
+          writtenExpression = isSgUnaryOp (node)->get_operand ();
+        }
+
+        if (writtenExpression == NULL)
+        {
+          return false;
+        }
+
+        SgType * type = writtenExpression->get_type ()->stripTypedefsAndModifiers ();
+
+        return isSgPntrArrRefExp (writtenExpression) || isSgPointerDerefExp (
+            writtenExpression) || isSgArrowExp (writtenExpression)
+            || isSgArrayType (type) || isSgPointerType (type);
+      }
+
+      bool
+      hasSideEffects (SgFunctionCallExp * functionCallExpression)
+      {
+        SgFunctionDeclaration * functionDeclaration =
+            functionCallExpression->getAssociatedFunctionDeclaration ();
+
+        if (functionDeclaration == NULL)
+        {
+          return true;
+        }
+
+        SgFunctionDeclaration * definingDeclaration = isSgFunctionDeclaration (
+            functionDeclaration->get_definingDeclaration ());
+
+        if (definingDeclaration == NULL
+            || definingDeclaration->get_definition () == NULL)
+        {
+          return isHarmlessExternalFunction (
+              functionDeclaration->get_name ().getString ()) == false;
+        }
+
+        if (sideEffects.count (definingDeclaration) > 0)
+        {
+          return sideEffects[definingDeclaration];
+        }
+
+        /*
+         * ======================================================
+         * Assume the worst while the function is being visited
+         * so that recursion terminates
+         * ======================================================
+         */
+        sideEffects[definingDeclaration] = true;
+
+        bool effects = false;
+
+        Rose_STL_Container <SgNode *> nodes = NodeQuery::querySubTree (
+            definingDeclaration->get_definition (), V_SgNode);
+
+        for (Rose_STL_Container <SgNode *>::iterator it = nodes.begin (); it
+            != nodes.end () && effects == false; ++it)
+        {
+          SgFunctionCallExp * calleeCall = isSgFunctionCallExp (*it);
+
+          if (calleeCall != NULL)
+          {
+            effects = parallelLoopCalls.count (calleeCall) > 0
+                || (isFetchCall (calleeCall) == false && hasSideEffects (
+                    calleeCall));
+          }
+          else
+          {
+            effects = isHostWrite (*it);
+          }
+        }
+
+        sideEffects[definingDeclaration] = effects;
+
+        return effects;
+      }
+
+      void
+      applyParallelLoop (SgFunctionCallExp * functionCallExpression,
+          State & state, bool const reportEffects)
+      {
+        using std::map;
+        using std::string;
+
+        ParallelLoop * parallelLoop = parallelLoopCalls[functionCallExpression];
+
+        map <unsigned int, string> opDatNames = getCallSiteOpDatNames (
+            declarations, functionCallExpression, parallelLoop);
+
+        std::set <string> writtenOpDats;
+
+        unsigned int reductions = 0;
+
+        for (unsigned int i = 1; i
+            <= parallelLoop->getNumberOfOpDatArgumentGroups (); ++i)
+        {
+          if (parallelLoop->isGlobal (i))
+          {
+            if (parallelLoop->isReductionRequired (i))
+            {
+              ++reductions;
+            }
+          }
+          else if (parallelLoop->isRead (i) == false)
+          {
+            state.erase (opDatNames[i]);
+
+            writtenOpDats.insert (opDatNames[i]);
+          }
+        }
+
+        if (reportEffects)
+        {
+          string entry = "  line " + boost::lexical_cast <string> (
+              functionCallExpression->get_file_info ()->get_line ())
+              + ": OP_PAR_LOOP " + parallelLoop->getUserSubroutineName ();
+
+          if (writtenOpDats.empty () == false)
+          {
+            entry += ", device writes " + boost::join (writtenOpDats, " ");
+          }
+
+          if (reductions > 0)
+          {
+            entry += ", " + boost::lexical_cast <string> (reductions)
+                + " reduction result(s) downloaded";
+          }
+
+          report.push_back (entry);
+        }
+      }
+
+      /*
+       * ======================================================
+       * Applies every effect found anywhere under this node
+       * without removing any fetch: used for statements whose
+       * control flow is not modelled
+       * ======================================================
+       */
+      void
+      applyEffects (SgNode * node, State & state)
+      {
+        Rose_STL_Container <SgNode *> nodes = NodeQuery::querySubTree (node,
+            V_SgNode);
+
+        for (Rose_STL_Container <SgNode *>::iterator it = nodes.begin (); it
+            != nodes.end (); ++it)
+        {
+          SgFunctionCallExp * functionCallExpression = isSgFunctionCallExp (*it);
+
+          if (functionCallExpression != NULL)
+          {
+            if (parallelLoopCalls.count (functionCallExpression) > 0)
+            {
+              applyParallelLoop (functionCallExpression, state, false);
+            }
+            else if (isFetchCall (functionCallExpression) == false
+                && hasSideEffects (functionCallExpression))
+            {
+              state.clear ();
+            }
+          }
+          else if (isHostWrite (*it))
+          {
+            state.clear ();
+          }
+        }
+      }
+
+      static State
+      meet (State const & first, State const & second)
+      {
+        State result;
+
+        for (State::const_iterator it = first.begin (); it != first.end (); ++it)
+        {
+          if (second.count (*it) > 0)
+          {
+            result.insert (*it);
+          }
+        }
+
+        return result;
+      }
+
+      void
+      analyseFetch (SgExprStatement * statement,
+          SgFunctionCallExp * functionCallExpression, State & state)
+      {
+        using std::string;
+
+        SgExpressionPtrList & arguments =
+            functionCallExpression->get_args ()->get_expressions ();
+
+        SgVarRefExp * opDatReference = arguments.empty () ? NULL : isSgVarRefExp (
+            arguments.front ());
+
+        if (opDatReference == NULL)
+        {
+          return;
+        }
+
+        string const opDatName =
+            opDatReference->get_symbol ()->get_name ().getString ();
+
+        string entry = "  line " + boost::lexical_cast <string> (
+            statement->get_file_info ()->get_line ()) + ": fetch " + opDatName;
+
+        if (state.count (opDatName) > 0)
+        {
+          Debug::getInstance ()->debugMessage ("Fetch of OP_DAT '" + opDatName
+              + "' is redundant", Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+          entry += " is redundant";
+
+          /*
+           * ======================================================
+           * A fetch forming the whole body of a branch or loop
+           * is reported but kept, as removing it would leave
+           * the construct without a body
+           * ======================================================
+           */
+          if (Globals::getInstance ()->eliminateTransfers () && isSgBasicBlock (
+              statement->get_parent ()))
+          {
+            redundantFetches.push_back (statement);
+
+            entry += " (removed)";
+          }
+        }
+        else
+        {
+          state.insert (opDatName);
+
+          entry += " is required";
+        }
+
+        report.push_back (entry);
+      }
+
+      void
+      analyse (SgStatement * statement, State & state)
+      {
+        if (SgBasicBlock * block = isSgBasicBlock (statement))
+        {
+          SgStatementPtrList & statements = block->get_statements ();
+
+          for (SgStatementPtrList::iterator it = statements.begin (); it
+              != statements.end (); ++it)
+          {
+            analyse (*it, state);
+          }
+        }
+        else if (SgIfStmt * ifStatement = isSgIfStmt (statement))
+        {
+          applyEffects (ifStatement->get_conditional (), state);
+
+          State trueState = state;
+
+          State falseState = state;
+
+          analyse (ifStatement->get_true_body (), trueState);
+
+          if (ifStatement->get_false_body () != NULL)
+          {
+            analyse (ifStatement->get_false_body (), falseState);
+          }
+
+          state = meet (trueState, falseState);
+        }
+        else if (isSgForStatement (statement) || isSgWhileStmt (statement)
+            || isSgDoWhileStmt (statement) || isSgFortranDo (statement))
+        {
+          SgStatement * body;
+
+          if (isSgForStatement (statement))
+          {
+            body = isSgForStatement (statement)->get_loop_body ();
+          }
+          else if (isSgWhileStmt (statement))
+          {
+            body = isSgWhileStmt (statement)->get_body ();
+          }
+          else if (isSgDoWhileStmt (statement))
+          {
+            body = isSgDoWhileStmt (statement)->get_body ();
+          }
+          else
+          {
+            body = isSgFortranDo (statement)->get_body ();
+          }
+
+          State entryState = state;
+
+          applyEffects (statement, entryState);
+
+          State bodyState = entryState;
+
+          analyse (body, bodyState);
+
+          state = meet (entryState, bodyState);
+        }
+        else if (SgExprStatement * expressionStatement = isSgExprStatement (
+            statement))
+        {
+          SgFunctionCallExp * functionCallExpression = isSgFunctionCallExp (
+              expressionStatement->get_expression ());
+
+          if (functionCallExpression != NULL && parallelLoopCalls.count (
+              functionCallExpression) > 0)
+          {
+            applyParallelLoop (functionCallExpression, state, true);
+          }
+          else if (functionCallExpression != NULL && isFetchCall (
+              functionCallExpression))
+          {
+            analyseFetch (expressionStatement, functionCallExpression, state);
+          }
+          else
+          {
+            applyEffects (statement, state);
+          }
+        }
+        else
+        {
+          applyEffects (statement, state);
+        }
+      }
+
+      void
+      writeReport ()
+      {
+        using std::ofstream;
+        using std::string;
+        using std::vector;
+
+        string const & fileName =
+            Globals::getInstance ()->getTransferReportFileName ();
+
+        if (fileName.empty ())
+        {
+          return;
+        }
+
+        ofstream outputFile (fileName.c_str ());
+
+        for (vector <string>::const_iterator it = report.begin (); it
+            != report.end (); ++it)
+        {
+          outputFile << *it << "\n";
+        }
+      }
+
+    public:
+
+      OpDatLiveness (TDeclarations * declarations) :
+        declarations (declarations)
+      {
+        using std::map;
+        using std::set;
+        using std::string;
+        using std::vector;
+
+        Debug::getInstance ()->debugMessage (
+            "Analysing liveness of OP_DATs on the host", Debug::VERBOSE_LEVEL,
+            __FILE__, __LINE__);
+
+        set <SgFunctionDefinition *> functionDefinitions;
+
+        for (typename map <string, ParallelLoop *>::const_iterator it =
+            declarations->firstParallelLoop (); it
+            != declarations->lastParallelLoop (); ++it)
+        {
+          for (vector <SgFunctionCallExp *>::const_iterator callIt =
+              it->second->getFirstFunctionCall (); callIt
+              != it->second->getLastFunctionCall (); ++callIt)
+          {
+            parallelLoopCalls[*callIt] = it->second;
+
+            functionDefinitions.insert (
+                SageInterface::getEnclosingFunctionDefinition (*callIt));
+          }
+        }
+
+        for (set <SgFunctionDefinition *>::const_iterator it =
+            functionDefinitions.begin (); it != functionDefinitions.end (); ++it)
+        {
+          if (*it == NULL)
+          {
+            continue;
+          }
+
+          report.push_back ((*it)->get_declaration ()->get_name ().getString ()
+              + " (" + (*it)->get_file_info ()->get_filenameString () + ")");
+
+          State state;
+
+          analyse ((*it)->get_body (), state);
+        }
+
+        for (vector <SgStatement *>::const_iterator it =
+            redundantFetches.begin (); it != redundantFetches.end (); ++it)
+        {
+          SageInterface::removeStatement (*it);
+        }
+
+        writeReport ();
+      }
+  };
+
+#endif
@@ -195,6 +195,28 @@ template <typename TSubroutineHeader>
       {
         return variableDeclarations;
       }
+
+      /*
+       * ======================================================
+       * Releases the state needed only while the subroutine is
+       * built. Afterwards only its header statement and name
+       * may be used
+       * ======================================================
+       */
+
+      virtual void
+      releaseBuilderState ()
+      {
+        delete variableDeclarations;
+
+        variableDeclarations = NULL;
+      }
+
+      virtual
+      ~Subroutine ()
+      {
+        delete variableDeclarations;
+      }
   };
 
 #endif
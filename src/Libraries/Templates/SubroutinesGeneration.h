@@ -199,6 +199,12 @@ template <typename TDeclarations, typename THostSubroutine>
         return newFileName;
       }
 
+      SgScopeStatement *
+      getModuleScope ()
+      {
+        return moduleScope;
+      }
+
       bool
       isDirty (std::string const & fileName)
       {
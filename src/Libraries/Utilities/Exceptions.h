@@ -273,6 +273,20 @@ namespace Exceptions
         {
         }
     };
+
+    class BackendGenerationException: public std::runtime_error
+    {
+      public:
+
+        static unsigned int const returnValue = 20;
+
+      public:
+
+        BackendGenerationException (const std::string& msg) :
+          std::runtime_error (msg)
+        {
+        }
+    };
   }
 
   namespace ASTParsing
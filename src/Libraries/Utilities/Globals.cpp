@@ -31,6 +31,7 @@
 
 
 #include <cstdlib>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <Globals.h>
 #include <Debug.h>
@@ -58,7 +59,21 @@ Globals::Globals ()
 
   preprocessOption = false;
 
+  syntacticFusionOption = false;
+
+  automaticFusionOption = false;
+
+  sparseTileSize = 0;
+
+  eliminateTransfersOption = false;
+
   uDrawOption = false;
+
+  cudaTemplatesOption = false;
+
+  cudaAtomicReductionsOption = false;
+
+  cudaCachedGlobalsOption = false;
 }
 
 /*
@@ -149,6 +164,244 @@ Globals::getSyntacticFusionKernels () const
 	return syntacticFusionKernels;
 }
 
+void
+Globals::setAutomaticFusion ()
+{
+  automaticFusionOption = true;
+}
+
+bool
+Globals::automaticFusion () const
+{
+  return automaticFusionOption;
+}
+
+void
+Globals::setSparseTileSize (unsigned int tileSize)
+{
+  sparseTileSize = tileSize;
+}
+
+bool
+Globals::sparseTiling () const
+{
+  return sparseTileSize > 0;
+}
+
+unsigned int
+Globals::getSparseTileSize () const
+{
+  return sparseTileSize;
+}
+
+void
+Globals::setLoopGraphFileName (std::string const & fileName)
+{
+  loopGraphFileName = fileName;
+}
+
+bool
+Globals::loopGraph () const
+{
+  return loopGraphFileName.empty () == false;
+}
+
+std::string const &
+Globals::getLoopGraphFileName () const
+{
+  return loopGraphFileName;
+}
+
+void
+Globals::setLoopTimingsFileName (std::string const & fileName)
+{
+  loopTimingsFileName = fileName;
+}
+
+std::string const &
+Globals::getLoopTimingsFileName () const
+{
+  return loopTimingsFileName;
+}
+
+void
+Globals::setEliminateTransfers ()
+{
+  eliminateTransfersOption = true;
+}
+
+bool
+Globals::eliminateTransfers () const
+{
+  return eliminateTransfersOption;
+}
+
+void
+Globals::setTransferReportFileName (std::string const & fileName)
+{
+  transferReportFileName = fileName;
+}
+
+std::string const &
+Globals::getTransferReportFileName () const
+{
+  return transferReportFileName;
+}
+
+bool
+Globals::transferAnalysis () const
+{
+  return eliminateTransfersOption || transferReportFileName.empty () == false;
+}
+
+void
+Globals::setGenerateCUDATemplates ()
+{
+  cudaTemplatesOption = true;
+}
+
+bool
+Globals::generateCUDATemplates () const
+{
+  return cudaTemplatesOption;
+}
+
+void
+Globals::setCUDARegisterLimitsFileName (std::string const & fileName)
+{
+  cudaRegisterLimitsFileName = fileName;
+}
+
+std::string const &
+Globals::getCUDARegisterLimitsFileName () const
+{
+  return cudaRegisterLimitsFileName;
+}
+
+void
+Globals::setCUDAAtomicReductions ()
+{
+  cudaAtomicReductionsOption = true;
+}
+
+bool
+Globals::useCUDAAtomicReductions () const
+{
+  return cudaAtomicReductionsOption;
+}
+
+void
+Globals::setCUDACachedGlobals ()
+{
+  cudaCachedGlobalsOption = true;
+}
+
+bool
+Globals::useCUDACachedGlobals () const
+{
+  return cudaCachedGlobalsOption;
+}
+
+void
+Globals::setPrecisionPolicyFileName (std::string const & fileName)
+{
+  precisionPolicyFileName = fileName;
+}
+
+std::string const &
+Globals::getPrecisionPolicyFileName () const
+{
+  return precisionPolicyFileName;
+}
+
+void
+Globals::setSetSizesFileName (std::string const & fileName)
+{
+  setSizesFileName = fileName;
+}
+
+std::string const &
+Globals::getSetSizesFileName () const
+{
+  return setSizesFileName;
+}
+
+void
+Globals::setTranslationCacheDirectory (std::string const & directoryName)
+{
+  translationCacheDirectory = directoryName;
+}
+
+std::string const &
+Globals::getTranslationCacheDirectory () const
+{
+  return translationCacheDirectory;
+}
+
+void
+Globals::setStatisticsFileName (std::string const & fileName)
+{
+  statisticsFileName = fileName;
+}
+
+std::string const &
+Globals::getStatisticsFileName () const
+{
+  return statisticsFileName;
+}
+
+void
+Globals::setCodeReportFileName (std::string const & fileName)
+{
+  codeReportFileName = fileName;
+}
+
+std::string const &
+Globals::getCodeReportFileName () const
+{
+  return codeReportFileName;
+}
+
+void
+Globals::addBatchBackend (TargetLanguage::BACKEND backend)
+{
+  if (std::find (batchBackends.begin (), batchBackends.end (), backend)
+      == batchBackends.end ())
+  {
+    batchBackends.push_back (backend);
+  }
+}
+
+std::vector <TargetLanguage::BACKEND> const &
+Globals::getBatchBackends () const
+{
+  return batchBackends;
+}
+
+void
+Globals::setSaveASTFileName (std::string const & fileName)
+{
+  saveASTFileName = fileName;
+}
+
+std::string const &
+Globals::getSaveASTFileName () const
+{
+  return saveASTFileName;
+}
+
+void
+Globals::setLoadASTFileName (std::string const & fileName)
+{
+  loadASTFileName = fileName;
+}
+
+std::string const &
+Globals::getLoadASTFileName () const
+{
+  return loadASTFileName;
+}
+
 void
 Globals::setOutputUDrawGraphs ()
 {
@@ -35,6 +35,8 @@
 #define GLOBALS_H
 
 #include <TargetLanguage.h>
+#include <string>
+#include <vector>
 
 class Globals
 {
@@ -54,8 +56,44 @@ class Globals
 
 	std::string syntacticFusionKernels;
 
+    bool automaticFusionOption;
+
+    unsigned int sparseTileSize;
+
+    std::string loopGraphFileName;
+
+    std::string loopTimingsFileName;
+
+    bool eliminateTransfersOption;
+
+    std::string transferReportFileName;
+
     bool uDrawOption;
 
+    bool cudaTemplatesOption;
+
+    std::string cudaRegisterLimitsFileName;
+
+    bool cudaAtomicReductionsOption;
+
+    bool cudaCachedGlobalsOption;
+
+    std::string precisionPolicyFileName;
+
+    std::string setSizesFileName;
+
+    std::string translationCacheDirectory;
+
+    std::string statisticsFileName;
+
+    std::string codeReportFileName;
+
+    std::vector <TargetLanguage::BACKEND> batchBackends;
+
+    std::string saveASTFileName;
+
+    std::string loadASTFileName;
+
     std::vector <std::string> inputFilenames;
 
     std::string freeVariablesModuleName;
@@ -136,7 +174,254 @@ class Globals
 	
 	std::string
 	getSyntacticFusionKernels () const;
+
+    void
+    setAutomaticFusion ();
+
+    /*
+     * ======================================================
+     * Should all legal chains of consecutive OP_PAR_LOOPs be
+     * fused?
+     * ======================================================
+     */
+    bool
+    automaticFusion () const;
+
+    void
+    setSparseTileSize (unsigned int tileSize);
+
+    /*
+     * ======================================================
+     * Should chains of OP_PAR_LOOPs connected through
+     * mappings be sparse tiled? This is the case when a
+     * non-zero tile size has been given
+     * ======================================================
+     */
+    bool
+    sparseTiling () const;
+
+    /*
+     * ======================================================
+     * The number of elements of the first loop of a chain
+     * that seed each tile
+     * ======================================================
+     */
+    unsigned int
+    getSparseTileSize () const;
+
+    void
+    setLoopGraphFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * Should the OP_PAR_LOOP dependence graph be exported?
+     * This is the case when a base file name has been given
+     * ======================================================
+     */
+    bool
+    loopGraph () const;
+
+    /*
+     * ======================================================
+     * The base name of the '.dot' and '.json' files holding
+     * the OP_PAR_LOOP dependence graph
+     * ======================================================
+     */
+    std::string const &
+    getLoopGraphFileName () const;
+
+    void
+    setLoopTimingsFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file of OP_kernels timings (as printed by
+     * op_timing_output) merged into the dependence graph
+     * ======================================================
+     */
+    std::string const &
+    getLoopTimingsFileName () const;
+
+    void
+    setEliminateTransfers ();
+
+    /*
+     * ======================================================
+     * Should fetches of OP_DATs whose host copy is already
+     * valid be removed?
+     * ======================================================
+     */
+    bool
+    eliminateTransfers () const;
+
+    void
+    setTransferReportFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file listing the host/device transfers found by the
+     * OP_DAT liveness analysis
+     * ======================================================
+     */
+    std::string const &
+    getTransferReportFileName () const;
+
+    /*
+     * ======================================================
+     * Should the OP_DAT liveness analysis be run?
+     * ======================================================
+     */
+    bool
+    transferAnalysis () const;
 	
+    void
+    setGenerateCUDATemplates ();
+
+    /*
+     * ======================================================
+     * Should CUDA kernels stage data through the generic
+     * templates rather than through fully expanded loops?
+     * ======================================================
+     */
+    bool
+    generateCUDATemplates () const;
+
+    void
+    setCUDARegisterLimitsFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file mapping user kernels to the maximum number of
+     * registers their CUDA kernels may use
+     * ======================================================
+     */
+    std::string const &
+    getCUDARegisterLimitsFileName () const;
+
+    void
+    setCUDAAtomicReductions ();
+
+    /*
+     * ======================================================
+     * Should scalar reductions in CUDA Fortran be finalised
+     * on the device with atomics rather than on the host?
+     * ======================================================
+     */
+    bool
+    useCUDAAtomicReductions () const;
+
+    void
+    setCUDACachedGlobals ();
+
+    /*
+     * ======================================================
+     * Should read-only OP_GBL arrays in CUDA Fortran stay on
+     * the device between calls and be uploaded again only
+     * when their host values change?
+     * ======================================================
+     */
+    bool
+    useCUDACachedGlobals () const;
+
+    void
+    setPrecisionPolicyFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file mapping OP_DATs to the precision in which
+     * generated kernels compute on their data
+     * ======================================================
+     */
+    std::string const &
+    getPrecisionPolicyFileName () const;
+
+    void
+    setSetSizesFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file giving the size of OP_SETs known before the
+     * program runs, for which code is specialised
+     * ======================================================
+     */
+    std::string const &
+    getSetSizesFileName () const;
+
+    void
+    setTranslationCacheDirectory (std::string const & directoryName);
+
+    /*
+     * ======================================================
+     * The directory holding translations reused when the
+     * inputs and options have not changed. Empty when no
+     * cache is used
+     * ======================================================
+     */
+    std::string const &
+    getTranslationCacheDirectory () const;
+
+    void
+    setStatisticsFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file to which per-phase timing and memory figures
+     * are written as JSON. Empty when none are recorded
+     * ======================================================
+     */
+    std::string const &
+    getStatisticsFileName () const;
+
+    void
+    setCodeReportFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file to which the size and resource usage of each
+     * generated kernel are written as JSON. Empty when no
+     * report is requested
+     * ======================================================
+     */
+    std::string const &
+    getCodeReportFileName () const;
+
+    void
+    addBatchBackend (TargetLanguage::BACKEND backend);
+
+    /*
+     * ======================================================
+     * The backends generated from a single parse of the
+     * input files, each into its own directory. Empty when a
+     * single backend is selected
+     * ======================================================
+     */
+    std::vector <TargetLanguage::BACKEND> const &
+    getBatchBackends () const;
+
+    void
+    setSaveASTFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file to which the AST built by the frontend is
+     * written, so later runs can reload it
+     * ======================================================
+     */
+    std::string const &
+    getSaveASTFileName () const;
+
+    void
+    setLoadASTFileName (std::string const & fileName);
+
+    /*
+     * ======================================================
+     * The file from which a previously saved AST is loaded
+     * instead of running the frontend
+     * ======================================================
+     */
+    std::string const &
+    getLoadASTFileName () const;
+
     void
     setOutputUDrawGraphs ();
 
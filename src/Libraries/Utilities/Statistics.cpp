@@ -0,0 +1,221 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <Statistics.h>
+#include <Globals.h>
+#include <Debug.h>
+#include <Exceptions.h>
+#include <rose.h>
+#include <boost/lexical_cast.hpp>
+#include <sys/resource.h>
+#include <fstream>
+
+Statistics * Statistics::statisticsInstance = NULL;
+
+namespace
+{
+  long
+  getPeakResidentKilobytes ()
+  {
+    struct rusage usage;
+
+    getrusage (RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+  }
+
+  std::string
+  escapeJSON (std::string const & text)
+  {
+    std::string escaped;
+
+    for (std::string::const_iterator it = text.begin (); it != text.end (); ++it)
+    {
+      if (*it == '"' || *it == '\\')
+      {
+        escaped += '\\';
+      }
+
+      escaped += *it;
+    }
+
+    return escaped;
+  }
+}
+
+Statistics::Statistics ()
+{
+}
+
+void
+Statistics::beginPhase (std::string const & name)
+{
+  using boost::posix_time::microsec_clock;
+
+  if (Globals::getInstance ()->getStatisticsFileName ().empty ())
+  {
+    return;
+  }
+
+  if (phases.empty () && name != "translator")
+  {
+    beginPhase ("translator");
+  }
+
+  Phase phase;
+
+  phase.name = name;
+
+  phase.start = microsec_clock::local_time ();
+
+  phase.wallSeconds = 0;
+
+  phase.peakResidentKilobytes = 0;
+
+  phase.numberOfNodesBefore = numberOfNodes ();
+
+  phase.numberOfNodesAfter = 0;
+
+  if (openPhases.empty () == false)
+  {
+    phases[openPhases.back ()].children.push_back (phases.size ());
+  }
+
+  openPhases.push_back (phases.size ());
+
+  phases.push_back (phase);
+}
+
+void
+Statistics::endPhase ()
+{
+  using boost::posix_time::microsec_clock;
+
+  if (openPhases.empty ())
+  {
+    return;
+  }
+
+  Phase & phase = phases[openPhases.back ()];
+
+  phase.wallSeconds = (microsec_clock::local_time () - phase.start).total_microseconds ()
+      / 1.0e6;
+
+  phase.peakResidentKilobytes = getPeakResidentKilobytes ();
+
+  phase.numberOfNodesAfter = numberOfNodes ();
+
+  Debug::getInstance ()->debugMessage ("Phase '" + phase.name + "' took "
+      + boost::lexical_cast <std::string> (phase.wallSeconds) + " s",
+      Debug::VERBOSE_LEVEL, __FILE__, __LINE__);
+
+  openPhases.pop_back ();
+}
+
+void
+Statistics::writePhase (std::ostream & output, unsigned int index,
+    std::string const & indent) const
+{
+  Phase const & phase = phases[index];
+
+  output << indent << "{\n";
+
+  output << indent << "  \"name\": \"" << escapeJSON (phase.name) << "\",\n";
+
+  output << indent << "  \"wallSeconds\": " << phase.wallSeconds << ",\n";
+
+  output << indent << "  \"peakResidentKilobytes\": "
+      << phase.peakResidentKilobytes << ",\n";
+
+  output << indent << "  \"astNodesBefore\": " << phase.numberOfNodesBefore
+      << ",\n";
+
+  output << indent << "  \"astNodesAfter\": " << phase.numberOfNodesAfter
+      << ",\n";
+
+  output << indent << "  \"phases\": [";
+
+  for (std::vector <unsigned int>::const_iterator it = phase.children.begin (); it
+      != phase.children.end (); ++it)
+  {
+    output << (it == phase.children.begin () ? "\n" : ",\n");
+
+    writePhase (output, *it, indent + "    ");
+  }
+
+  output << (phase.children.empty () ? "]\n" : "\n" + indent + "  ]\n");
+
+  output << indent << "}";
+}
+
+void
+Statistics::output ()
+{
+  using std::ofstream;
+  using std::string;
+
+  string const & fileName = Globals::getInstance ()->getStatisticsFileName ();
+
+  if (fileName.empty () || phases.empty ())
+  {
+    return;
+  }
+
+  while (openPhases.empty () == false)
+  {
+    endPhase ();
+  }
+
+  ofstream outputFile (fileName.c_str ());
+
+  if (outputFile.is_open () == false)
+  {
+    throw Exceptions::CodeGeneration::FileCreationException (
+        "Unable to create statistics file '" + fileName + "'");
+  }
+
+  writePhase (outputFile, 0, "");
+
+  outputFile << std::endl;
+
+  outputFile.close ();
+}
+
+Statistics *
+Statistics::getInstance ()
+{
+  if (statisticsInstance == NULL)
+  {
+    statisticsInstance = new Statistics ();
+  }
+  return statisticsInstance;
+}
@@ -0,0 +1,136 @@
+
+
+
+/*  Open source copyright declaration based on BSD open source template:
+ *  http://www.opensource.org/licenses/bsd-license.php
+ * 
+ * Copyright (c) 2011-2012, Adam Betts, Carlo Bertolli
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Records the wall time, peak resident set size and number of AST nodes
+ * of each phase of the translation, so that the cost of translating large
+ * codes can be attributed and tracked
+ */
+
+#pragma once
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <string>
+#include <vector>
+
+class Statistics
+{
+  private:
+
+    class Phase
+    {
+      public:
+
+        std::string name;
+
+        boost::posix_time::ptime start;
+
+        double wallSeconds;
+
+        long peakResidentKilobytes;
+
+        unsigned long numberOfNodesBefore;
+
+        unsigned long numberOfNodesAfter;
+
+        std::vector <unsigned int> children;
+    };
+
+    static Statistics * statisticsInstance;
+
+    /*
+     * ======================================================
+     * All phases in the order they began. Phases that are
+     * not nested in another phase are children of the
+     * first, which covers the whole run
+     * ======================================================
+     */
+    std::vector <Phase> phases;
+
+    std::vector <unsigned int> openPhases;
+
+  private:
+
+    void
+    writePhase (std::ostream & output, unsigned int index,
+        std::string const & indent) const;
+
+    /*
+     * ======================================================
+     * Private constructor ensures users can never create
+     * multiple instances
+     * ======================================================
+     */
+    Statistics ();
+
+  public:
+
+    /*
+     * ======================================================
+     * This always returns a single instance of the Statistics
+     * class to make it compliant with the singleton pattern
+     * ======================================================
+     */
+    static Statistics *
+    getInstance ();
+
+    /*
+     * ======================================================
+     * Starts a phase nested in the innermost open phase.
+     * Nothing is recorded unless a statistics file has been
+     * requested
+     * ======================================================
+     */
+    void
+    beginPhase (std::string const & name);
+
+    /*
+     * ======================================================
+     * Ends the innermost open phase
+     * ======================================================
+     */
+    void
+    endPhase ();
+
+    /*
+     * ======================================================
+     * Ends the whole run and writes all phases as JSON to
+     * the requested statistics file
+     * ======================================================
+     */
+    void
+    output ();
+};
+
+#endif